@@ -0,0 +1,231 @@
+#include "audio.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+constexpr int kSampleRate = 48000;     ///< Requested device rate.
+constexpr Uint16 kBufferFrames = 256;  ///< Requested device buffer, ~5 ms at 48 kHz.
+constexpr double kPi = 3.14159265358979323846;
+
+/**
+ * @brief Parameters of a synthesized effect: a sine sweep with a short attack and exponential decay.
+ */
+struct Tone {
+  double duration_s;
+  double start_hz;
+  double end_hz;
+  double gain;
+  double harmonic;  ///< Level of the added third harmonic, for a harsher timbre.
+};
+
+} // namespace
+
+/**
+ * @brief Opens the audio device and decodes every effect before playback starts.
+ *
+ * The device is requested as mono 32-bit float with a small buffer and no allowed format changes, so
+ * SDL converts if the hardware differs and the mixer always works on the format it decoded to. Any
+ * failure is logged and leaves the system silent.
+ */
+AudioSystem::AudioSystem() {
+  if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+    std::cerr << "Audio could not be initialized, running silent. SDL_Error: " << SDL_GetError() << "\n";
+    return;
+  }
+
+  SDL_AudioSpec desired{};
+  desired.freq = kSampleRate;
+  desired.format = AUDIO_F32SYS;
+  desired.channels = 1;
+  desired.samples = kBufferFrames;
+  desired.callback = &AudioSystem::Callback;
+  desired.userdata = this;
+  device = SDL_OpenAudioDevice(nullptr, 0, &desired, &spec, 0);
+  if (device == 0) {
+    std::cerr << "Audio device could not be opened, running silent. SDL_Error: " << SDL_GetError() << "\n";
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    return;
+  }
+
+  LoadEffect(Effect::kEat, "eat");
+  LoadEffect(Effect::kTurn, "turn");
+  LoadEffect(Effect::kDeath, "death");
+  SDL_PauseAudioDevice(device, 0);
+}
+
+/**
+ * @brief Closes the audio device; SDL guarantees the callback is no longer running afterwards.
+ */
+AudioSystem::~AudioSystem() {
+  if (device != 0) {
+    SDL_CloseAudioDevice(device);
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+  }
+}
+
+/**
+ * @brief Decodes an effect from ../resources/sounds/<name>.wav, or synthesizes it if the file is missing.
+ *
+ * WAV data is converted to mono float at the device rate with SDL_AudioCVT.
+ */
+void AudioSystem::LoadEffect(Effect effect, const char *name) {
+  const std::string path = std::string("../resources/sounds/") + name + ".wav";
+  SDL_AudioSpec wav_spec{};
+  Uint8 *wav_buffer = nullptr;
+  Uint32 wav_length = 0;
+  if (!SDL_LoadWAV(path.c_str(), &wav_spec, &wav_buffer, &wav_length)) {
+    effects[static_cast<int>(effect)] = Synthesize(effect);
+    return;
+  }
+
+  SDL_AudioCVT cvt;
+  std::vector<Uint8> data;
+  if (SDL_BuildAudioCVT(&cvt, wav_spec.format, wav_spec.channels, wav_spec.freq, AUDIO_F32SYS, 1, spec.freq) < 0) {
+    std::cerr << "Sound " << path << " could not be converted, using the built-in one.\n";
+    SDL_FreeWAV(wav_buffer);
+    effects[static_cast<int>(effect)] = Synthesize(effect);
+    return;
+  }
+  data.resize(static_cast<std::size_t>(wav_length) * std::max(cvt.len_mult, 1));
+  std::memcpy(data.data(), wav_buffer, wav_length);
+  SDL_FreeWAV(wav_buffer);
+  cvt.len = static_cast<int>(wav_length);
+  cvt.buf = data.data();
+  int converted_length = static_cast<int>(wav_length);
+  if (cvt.needed && SDL_ConvertAudio(&cvt) == 0) {
+    converted_length = cvt.len_cvt;
+  }
+
+  std::vector<float> &samples = effects[static_cast<int>(effect)];
+  samples.resize(static_cast<std::size_t>(converted_length) / sizeof(float));
+  std::memcpy(samples.data(), data.data(), samples.size() * sizeof(float));
+}
+
+/**
+ * @brief Synthesizes the built-in version of an effect at the device rate.
+ */
+std::vector<float> AudioSystem::Synthesize(Effect effect) const {
+  static constexpr Tone kTones[kEffectCount] = {
+      {0.09, 660.0, 1320.0, 0.5, 0.0},   // kEat: short rising blip.
+      {0.03, 1800.0, 1800.0, 0.25, 0.0}, // kTurn: quiet click.
+      {0.45, 440.0, 110.0, 0.6, 0.3},    // kDeath: falling, buzzy tone.
+  };
+  const Tone &tone = kTones[static_cast<int>(effect)];
+  const std::size_t length = static_cast<std::size_t>(tone.duration_s * spec.freq);
+
+  std::vector<float> samples(length);
+  double phase = 0.0;
+  for (std::size_t i = 0; i < length; ++i) {
+    double t = static_cast<double>(i) / length;
+    double frequency = tone.start_hz + (tone.end_hz - tone.start_hz) * t;
+    phase += 2.0 * kPi * frequency / spec.freq;
+    double envelope = std::min(1.0, i / (0.005 * spec.freq)) * std::exp(-4.0 * t);
+    double value = std::sin(phase) + tone.harmonic * std::sin(3.0 * phase);
+    samples[i] = static_cast<float>(tone.gain * envelope * value / (1.0 + tone.harmonic));
+  }
+  return samples;
+}
+
+/**
+ * @brief Queues an effect for playback without locking.
+ *
+ * The trigger is written before the tail is published with release semantics, so the callback only
+ * ever reads complete triggers. If the queue is full the trigger is dropped and counted.
+ */
+void AudioSystem::Play(Effect effect) {
+  if (device == 0) {
+    return;
+  }
+  std::uint32_t tail = queue_tail.load(std::memory_order_relaxed);
+  if (tail - queue_head.load(std::memory_order_acquire) >= kQueueSize) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  queue[tail & (kQueueSize - 1)] = Trigger{effect, SDL_GetPerformanceCounter()};
+  queue_tail.store(tail + 1, std::memory_order_release);
+}
+
+/**
+ * @brief SDL audio callback, forwarded to Mix().
+ */
+void AudioSystem::Callback(void *userdata, Uint8 *stream, int len) {
+  static_cast<AudioSystem *>(userdata)->Mix(reinterpret_cast<float *>(stream), len / static_cast<int>(sizeof(float)));
+}
+
+/**
+ * @brief Starts queued effects and mixes all active voices into the output buffer.
+ *
+ * Runs on the SDL audio thread with only fixed-size arrays, so it never allocates or locks. The
+ * latency of each trigger is measured from when it was posted to when its first sample is mixed.
+ */
+void AudioSystem::Mix(float *out, int frames) {
+  std::fill(out, out + frames, 0.0f);
+
+  const Uint64 now = SDL_GetPerformanceCounter();
+  const Uint64 frequency = SDL_GetPerformanceFrequency();
+  std::uint32_t head = queue_head.load(std::memory_order_relaxed);
+  const std::uint32_t tail = queue_tail.load(std::memory_order_acquire);
+  for (; head != tail; ++head) {
+    const Trigger &trigger = queue[head & (kQueueSize - 1)];
+    latency_us.Record((now - trigger.posted) * 1000000 / frequency);
+    for (Voice &voice : voices) {
+      if (!voice.samples) {
+        voice.samples = &effects[static_cast<int>(trigger.effect)];
+        voice.position = 0;
+        break;
+      }
+    }
+  }
+  queue_head.store(head, std::memory_order_release);
+
+  for (Voice &voice : voices) {
+    if (!voice.samples) {
+      continue;
+    }
+    const std::size_t count = std::min<std::size_t>(frames, voice.samples->size() - voice.position);
+    const float *source = voice.samples->data() + voice.position;
+    for (std::size_t i = 0; i < count; ++i) {
+      out[i] += source[i];
+    }
+    voice.position += count;
+    if (voice.position >= voice.samples->size()) {
+      voice.samples = nullptr;
+    }
+  }
+
+  for (int i = 0; i < frames; ++i) {
+    out[i] = std::clamp(out[i], -1.0f, 1.0f);
+  }
+}
+
+/**
+ * @brief Prints the measured event-to-sound latency against the audio buffer length.
+ *
+ * A trigger posted just after a callback waits at most one buffer period for the next one, so the
+ * worst case should stay within one buffer.
+ */
+void AudioSystem::Report(std::ostream &out) const {
+  if (device == 0) {
+    return;
+  }
+  const double buffer_ms = 1000.0 * spec.samples / spec.freq;
+  Histogram::Snapshot latency = latency_us.Read();
+  const char *driver = SDL_GetCurrentAudioDriver();
+  out << std::fixed << std::setprecision(2)
+      << "Audio (" << (driver ? driver : "no driver") << ", " << spec.freq << " Hz, buffer " << buffer_ms << " ms): "
+      << latency.count << " effects, event-to-mix latency p50 " << latency.Percentile(50) / 1000.0
+      << " ms, p99 " << latency.Percentile(99) / 1000.0 << " ms, max " << latency.max / 1000.0 << " ms";
+  if (latency.count > 0) {
+    out << (latency.max / 1000.0 <= buffer_ms ? " (within one buffer)" : " (exceeds one buffer)");
+  }
+  std::uint64_t lost = dropped.load(std::memory_order_relaxed);
+  if (lost > 0) {
+    out << ", " << lost << " dropped";
+  }
+  out << "\n";
+}
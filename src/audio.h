@@ -0,0 +1,96 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "SDL.h"
+#include "histogram.h"
+
+/**
+ * @brief Plays the game's sound effects with low, bounded latency.
+ *
+ * All effects are decoded to mono float PCM at the device rate when the system is constructed. The
+ * simulation thread posts triggers through a single-producer lock-free queue, and the SDL audio
+ * callback drains it and mixes the active voices without allocating or locking. If no audio device
+ * can be opened the game simply stays silent.
+ *
+ * Effects can be replaced by WAV files in ../resources/sounds/ (eat.wav, turn.wav, death.wav);
+ * otherwise built-in tones are synthesized.
+ */
+class AudioSystem {
+public:
+  /**
+   * @brief Sound effects triggered by simulation events.
+   */
+  enum class Effect { kEat, kTurn, kDeath };
+
+  /**
+   * @brief Opens the audio device and decodes every effect.
+   */
+  AudioSystem();
+
+  /**
+   * @brief Closes the audio device.
+   */
+  ~AudioSystem();
+
+  AudioSystem(const AudioSystem &) = delete;
+  AudioSystem &operator=(const AudioSystem &) = delete;
+
+  /**
+   * @brief Queues an effect for playback. Lock-free; must only be called from one thread at a time.
+   *
+   * @param effect Effect to play.
+   */
+  void Play(Effect effect);
+
+  /**
+   * @brief Prints the measured event-to-sound latency against the audio buffer length.
+   *
+   * @param out Stream to print to.
+   */
+  void Report(std::ostream &out) const;
+
+private:
+  static constexpr int kEffectCount = 3;    ///< Number of entries in Effect.
+  static constexpr std::uint32_t kQueueSize = 64; ///< Capacity of the trigger queue, a power of two.
+  static constexpr int kMaxVoices = 16;     ///< Effects that can sound at the same time.
+
+  /**
+   * @brief A queued request to start an effect.
+   */
+  struct Trigger {
+    Effect effect;       ///< Effect to start.
+    Uint64 posted;       ///< Performance counter value when the trigger was posted.
+  };
+
+  /**
+   * @brief An effect that is currently playing.
+   */
+  struct Voice {
+    const std::vector<float> *samples{nullptr}; ///< PCM of the effect, nullptr if the voice is free.
+    std::size_t position{0};                    ///< Next sample to mix.
+  };
+
+  static void Callback(void *userdata, Uint8 *stream, int len);
+  void Mix(float *out, int frames);
+  void LoadEffect(Effect effect, const char *name);
+  std::vector<float> Synthesize(Effect effect) const;
+
+  SDL_AudioDeviceID device{0};                          ///< Open device, 0 if audio is unavailable.
+  SDL_AudioSpec spec{};                                 ///< Format of the open device.
+  std::array<std::vector<float>, kEffectCount> effects; ///< Decoded PCM per effect.
+
+  std::array<Trigger, kQueueSize> queue{};              ///< Ring buffer of pending triggers.
+  std::atomic<std::uint32_t> queue_head{0};             ///< Next slot to read, owned by the callback.
+  std::atomic<std::uint32_t> queue_tail{0};             ///< Next slot to write, owned by the producer.
+  std::atomic<std::uint64_t> dropped{0};                ///< Triggers lost because the queue was full.
+
+  std::array<Voice, kMaxVoices> voices{};               ///< Mixer voices, only touched by the callback.
+  Histogram latency_us;                                 ///< Trigger-to-mix latency in microseconds.
+};
+
+#endif // AUDIO_H
@@ -0,0 +1,102 @@
+#include "autopilot.h"
+#include <cstdlib>
+#include <limits>
+#include "gamerules.h"
+
+namespace {
+
+/**
+ * @brief Returns the shortest distance between two coordinates on a wrapping axis.
+ */
+int WrappedDistance(int a, int b, int size) {
+  int distance = std::abs(a - b);
+  return distance < size - distance ? distance : size - distance;
+}
+
+} // namespace
+
+/**
+ * @brief Brings the map of entered cells up to date with the snake's body.
+ *
+ * The body gains at most one segment at the front per move and loses segments only at the back, so the
+ * segments at the front that are newer than the last update are the only cells whose stamps change; any
+ * older stamp is at least as old as the body is long and reads as free. The map is rebuilt only when the
+ * body was replaced or the stamps would overflow.
+ */
+void AutoPilot::Track(const Snake &snake) {
+  const std::size_t cells = static_cast<std::size_t>(snake.GetGridWidth()) * snake.GetGridHeight();
+  std::size_t count = snake.body.size();
+  if (!tracking || snake.generation != generation || entered.size() != cells ||
+      snake.moves - base_moves >= kMaxTrackedMoves) {
+    entered.assign(cells, 0);
+    base_moves = snake.moves;
+    generation = snake.generation;
+    tracking = true;
+  } else if (snake.moves - tracked_moves < count) {
+    count = static_cast<std::size_t>(snake.moves - tracked_moves);
+  }
+  // Stamp from the tail towards the head, so the newest visit of a cell wins.
+  for (std::size_t age = count; age-- > 0;) {
+    const SDL_Point &cell = snake.body[age];
+    entered[static_cast<std::size_t>(cell.y) * snake.GetGridWidth() + cell.x] = Stamp(snake, age);
+  }
+  tracked_moves = snake.moves;
+}
+
+/**
+ * @brief Returns true if a cell is covered by the body.
+ *
+ * body[i] was left by the head i moves ago, so a cell is covered if the head last left it fewer moves ago
+ * than the body is long.
+ */
+bool AutoPilot::Occupied(const Snake &snake, int x, int y) const {
+  const std::uint32_t stamp = entered[static_cast<std::size_t>(y) * snake.GetGridWidth() + x];
+  return stamp + snake.body.size() > Stamp(snake, 0);
+}
+
+/**
+ * @brief Chooses the free neighbouring cell closest to the food.
+ *
+ * Only the current direction and turns GameRules::CanTurn allows are considered, so the AutoPilot
+ * follows the same rule as the controller. Ties are broken in favour of the current direction to avoid needless turns.
+ *
+ * @param snake Snake to steer; only read.
+ * @param food Current food position.
+ * @return Snake::Direction Direction to move in.
+ */
+Snake::Direction AutoPilot::Choose(const Snake &snake, const SDL_Point &food) {
+  Track(snake);
+  static constexpr Snake::Direction kDirections[] = {Snake::Direction::kUp, Snake::Direction::kDown,
+                                                     Snake::Direction::kLeft, Snake::Direction::kRight};
+  const int width = snake.GetGridWidth();
+  const int height = snake.GetGridHeight();
+  const int head_x = static_cast<int>(snake.head_x);
+  const int head_y = static_cast<int>(snake.head_y);
+
+  Snake::Direction best = snake.direction;
+  int best_distance = std::numeric_limits<int>::max();
+  for (Snake::Direction direction : kDirections) {
+    if (direction != snake.direction && !GameRules::CanTurn(snake, direction)) {
+      continue;
+    }
+
+    int x = head_x;
+    int y = head_y;
+    switch (direction) {
+      case Snake::Direction::kUp: y = (y + height - 1) % height; break;
+      case Snake::Direction::kDown: y = (y + 1) % height; break;
+      case Snake::Direction::kLeft: x = (x + width - 1) % width; break;
+      case Snake::Direction::kRight: x = (x + 1) % width; break;
+    }
+    if (Occupied(snake, x, y)) {
+      continue;
+    }
+
+    int distance = WrappedDistance(x, food.x, width) + WrappedDistance(y, food.y, height);
+    if (distance < best_distance || (distance == best_distance && direction == snake.direction)) {
+      best = direction;
+      best_distance = distance;
+    }
+  }
+  return best;
+}
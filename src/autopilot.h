@@ -0,0 +1,59 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <cstdint>
+#include <vector>
+#include "SDL.h"
+#include "snake.h"
+
+/**
+ * @brief Simple AI that steers the snake towards the food without running into itself.
+ *
+ * The autopilot is greedy: it looks one cell ahead and picks the free neighbour closest to the food,
+ * taking wrap-around into account. It is good enough to keep unattended games going for a while and
+ * still dies eventually, which exercises the game over and restart path as well.
+ *
+ * To check cells in constant time, the autopilot keeps a map of the grid that records when the head last
+ * left each cell. It is brought up to date from the cells the head left since the previous call,
+ * and rebuilt only when the body was replaced, so steering costs no body scan per move.
+ */
+class AutoPilot {
+public:
+  /**
+   * @brief Chooses the direction for the snake's next move.
+   *
+   * @param snake Snake to steer; only read.
+   * @param food Current food position.
+   * @return Snake::Direction Direction to move in. If every neighbour is blocked, the current direction.
+   */
+  Snake::Direction Choose(const Snake &snake, const SDL_Point &food);
+
+private:
+  static constexpr std::uint32_t kStampOffset = 1u << 25; ///< Above the largest body, so stamps never underflow.
+  static constexpr std::uint64_t kMaxTrackedMoves = 1u << 31; ///< Moves after which the map is rebuilt.
+
+  /**
+   * @brief Brings the map of entered cells up to date with the snake's body.
+   */
+  void Track(const Snake &snake);
+
+  /**
+   * @brief Returns true if a cell is covered by the body, as Snake::SnakeCell would.
+   */
+  bool Occupied(const Snake &snake, int x, int y) const;
+
+  /**
+   * @brief Returns the stamp of the cell the head left the given number of moves ago.
+   */
+  std::uint32_t Stamp(const Snake &snake, std::size_t age) const {
+    return kStampOffset + static_cast<std::uint32_t>(snake.moves - base_moves) - static_cast<std::uint32_t>(age);
+  }
+
+  std::vector<std::uint32_t> entered; ///< Per cell, the stamp of the last time the head left it; 0 if never.
+  std::uint64_t base_moves{0};        ///< Snake::moves when the map was rebuilt.
+  std::uint64_t tracked_moves{0};     ///< Snake::moves when the map was last updated.
+  std::uint64_t generation{0};        ///< Snake::generation the map was built for.
+  bool tracking{false};               ///< Whether the map holds a snake at all.
+};
+
+#endif // AUTOPILOT_H
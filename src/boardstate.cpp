@@ -0,0 +1,376 @@
+#include "boardstate.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "savegame.h"
+
+namespace {
+
+/**
+ * @brief Returns the cell next to (x, y) in a direction, wrapping at the grid edges.
+ */
+SDL_Point Neighbour(SDL_Point cell, Snake::Direction direction, int width, int height) {
+  switch (direction) {
+    case Snake::Direction::kUp: cell.y = (cell.y + height - 1) % height; break;
+    case Snake::Direction::kDown: cell.y = (cell.y + 1) % height; break;
+    case Snake::Direction::kLeft: cell.x = (cell.x + width - 1) % width; break;
+    case Snake::Direction::kRight: cell.x = (cell.x + 1) % width; break;
+  }
+  return cell;
+}
+
+/**
+ * @brief Returns true if two cells share an edge, counting neighbours across the wrapped grid edges.
+ */
+bool Adjacent(const SDL_Point &a, const SDL_Point &b, int width, int height) {
+  const int dx = ((b.x - a.x) % width + width) % width;
+  const int dy = ((b.y - a.y) % height + height) % height;
+  return (dy == 0 && (dx == 1 || dx == width - 1)) || (dx == 0 && (dy == 1 || dy == height - 1));
+}
+
+/**
+ * @brief Returns true if a cell lies on the grid.
+ */
+bool OnGrid(const SDL_Point &cell, int width, int height) {
+  return cell.x >= 0 && cell.x < width && cell.y >= 0 && cell.y < height;
+}
+
+/**
+ * @brief Builds a state from a path given from the tail to the head.
+ *
+ * The tail is shortened until at least a row's worth of cells is free, so the game can go on for a
+ * while before the grid is full. The food is put on the first free cell and the direction continues
+ * the path's last move.
+ */
+BoardState FromPath(std::vector<SDL_Point> path, int width, int height) {
+  const std::size_t cells = static_cast<std::size_t>(width) * height;
+  const std::size_t free_cells = std::max<std::size_t>(width, 2);
+  if (path.size() + free_cells > cells) {
+    path.erase(path.begin(), path.begin() + (path.size() + free_cells - cells));
+  }
+
+  BoardState state;
+  state.grid_width = width;
+  state.grid_height = height;
+  const SDL_Point head = path.back();
+  state.head_x = static_cast<float>(head.x);
+  state.head_y = static_cast<float>(head.y);
+  state.body.assign(path.rbegin() + 1, path.rend());
+  state.score = static_cast<int>(state.body.size());
+
+  if (!state.body.empty()) {
+    for (Snake::Direction direction : {Snake::Direction::kUp, Snake::Direction::kDown, Snake::Direction::kLeft,
+                                       Snake::Direction::kRight}) {
+      SDL_Point next = Neighbour(state.body.front(), direction, width, height);
+      if (next.x == head.x && next.y == head.y) {
+        state.direction = direction;
+        break;
+      }
+    }
+  }
+
+  std::vector<bool> occupied(static_cast<std::size_t>(width) * height, false);
+  for (const SDL_Point &cell : path) {
+    occupied[static_cast<std::size_t>(cell.y) * width + cell.x] = true;
+  }
+  for (std::size_t i = 0; i < occupied.size(); ++i) {
+    if (!occupied[i]) {
+      state.food = SDL_Point{static_cast<int>(i % width), static_cast<int>(i / width)};
+      break;
+    }
+  }
+  return state;
+}
+
+/**
+ * @brief Parses "WxH" into grid dimensions.
+ */
+bool ParseSize(const std::string &text, int &width, int &height) {
+  char *end = nullptr;
+  long w = std::strtol(text.c_str(), &end, 10);
+  if (end == text.c_str() || *end != 'x') {
+    return false;
+  }
+  const char *rest = end + 1;
+  long h = std::strtol(rest, &end, 10);
+  if (end == rest || *end != '\0' || w <= 0 || h <= 0 || w > kMaxGridSide || h > kMaxGridSide) {
+    return false;
+  }
+  width = static_cast<int>(w);
+  height = static_cast<int>(h);
+  return true;
+}
+
+} // namespace
+
+/**
+ * @brief Checks that a state could occur in a game.
+ *
+ * Runs in time linear in the body length plus the grid size.
+ *
+ * @param state State to check.
+ * @param error Receives the reason if the state is invalid.
+ * @return true if the state is valid.
+ */
+bool ValidateBoard(const BoardState &state, std::string &error) {
+  const int width = state.grid_width;
+  const int height = state.grid_height;
+  if (width <= 0 || height <= 0) {
+    error = "grid must not be empty";
+    return false;
+  }
+  if (width > kMaxGridSide || height > kMaxGridSide) {
+    error = "grid is larger than " + std::to_string(kMaxGridSide) + " cells per side";
+    return false;
+  }
+  if (!(state.head_x >= 0.0f && state.head_x < width && state.head_y >= 0.0f && state.head_y < height)) {
+    error = "head is off the grid";
+    return false;
+  }
+  if (!(state.speed > 0.0f) || !std::isfinite(state.speed)) {
+    error = "speed must be positive";
+    return false;
+  }
+  if (state.score < 0) {
+    error = "score must not be negative";
+    return false;
+  }
+  if (state.body.size() + 1 >= static_cast<std::size_t>(width) * height) {
+    error = "snake leaves no free cell for the food";
+    return false;
+  }
+
+  const SDL_Point head{static_cast<int>(state.head_x), static_cast<int>(state.head_y)};
+  std::vector<bool> occupied(static_cast<std::size_t>(width) * height, false);
+  occupied[static_cast<std::size_t>(head.y) * width + head.x] = true;
+  SDL_Point previous = head;
+  for (std::size_t i = 0; i < state.body.size(); ++i) {
+    const SDL_Point &cell = state.body[i];
+    if (!OnGrid(cell, width, height)) {
+      error = "body cell " + std::to_string(i) + " is off the grid";
+      return false;
+    }
+    if (!Adjacent(previous, cell, width, height)) {
+      error = "body cell " + std::to_string(i) + " is not next to the previous one";
+      return false;
+    }
+    std::vector<bool>::reference taken = occupied[static_cast<std::size_t>(cell.y) * width + cell.x];
+    if (taken) {
+      error = "body cell " + std::to_string(i) + " overlaps the snake";
+      return false;
+    }
+    taken = true;
+    previous = cell;
+  }
+
+  if (!state.body.empty()) {
+    SDL_Point next = Neighbour(head, state.direction, width, height);
+    if (next.x == state.body.front().x && next.y == state.body.front().y) {
+      error = "snake is heading into its own body";
+      return false;
+    }
+  }
+  if (!OnGrid(state.food, width, height)) {
+    error = "food is off the grid";
+    return false;
+  }
+  if (occupied[static_cast<std::size_t>(state.food.y) * width + state.food.x]) {
+    error = "food is on the snake";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Parses a board in the text format.
+ *
+ * @param in Stream to read.
+ * @param state Receives the parsed state.
+ * @param error Receives the reason if parsing failed.
+ * @return true if the text was parsed.
+ */
+bool ParseBoardText(std::istream &in, BoardState &state, std::string &error) {
+  state = BoardState();
+  std::string line;
+  int line_number = 0;
+  while (std::getline(in, line)) {
+    line_number++;
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    std::string keyword;
+    if (!(fields >> keyword)) {
+      continue;
+    }
+
+    bool ok = true;
+    if (keyword == "grid") {
+      ok = static_cast<bool>(fields >> state.grid_width >> state.grid_height);
+    } else if (keyword == "head") {
+      ok = static_cast<bool>(fields >> state.head_x >> state.head_y);
+    } else if (keyword == "body") {
+      SDL_Point cell;
+      while (fields >> cell.x) {
+        ok = static_cast<bool>(fields >> cell.y);
+        if (!ok) break;
+        state.body.push_back(cell);
+      }
+    } else if (keyword == "direction") {
+      std::string direction;
+      fields >> direction;
+      if (direction == "up") state.direction = Snake::Direction::kUp;
+      else if (direction == "down") state.direction = Snake::Direction::kDown;
+      else if (direction == "left") state.direction = Snake::Direction::kLeft;
+      else if (direction == "right") state.direction = Snake::Direction::kRight;
+      else ok = false;
+    } else if (keyword == "speed") {
+      ok = static_cast<bool>(fields >> state.speed);
+    } else if (keyword == "score") {
+      ok = static_cast<bool>(fields >> state.score);
+    } else if (keyword == "growing") {
+      int growing = 0;
+      ok = static_cast<bool>(fields >> growing);
+      state.growing = growing != 0;
+    } else if (keyword == "food") {
+      ok = static_cast<bool>(fields >> state.food.x >> state.food.y);
+    } else {
+      error = "line " + std::to_string(line_number) + ": unknown keyword '" + keyword + "'";
+      return false;
+    }
+
+    std::string extra;
+    if (ok && keyword != "body" && fields >> extra) {
+      ok = false;
+    }
+    if (!ok) {
+      error = "line " + std::to_string(line_number) + ": invalid " + keyword;
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Copies the game position of a save file into a state.
+ *
+ * @param save Save file whose header passed the save file checks.
+ * @param state Receives the state; it still has to be validated.
+ */
+void BoardFromSave(const SaveFile &save, BoardState &state) {
+  const SaveHeader &header = save.Header();
+  state.grid_width = header.grid_width;
+  state.grid_height = header.grid_height;
+  state.head_x = header.head_x;
+  state.head_y = header.head_y;
+  state.body.assign(save.Body(), save.Body() + header.body_length);
+  state.direction = static_cast<Snake::Direction>(header.direction);
+  state.speed = header.speed;
+  state.growing = header.growing != 0;
+  state.score = header.score;
+  state.food = header.food;
+}
+
+/**
+ * @brief Loads a board from a save file or a text file, then validates it.
+ *
+ * @param path File to load.
+ * @param state Receives the state.
+ * @param error Receives the reason if loading or validation failed.
+ * @return true if a valid state was loaded.
+ */
+bool LoadBoard(const std::string &path, BoardState &state, std::string &error) {
+  if (IsSaveFile(path)) {
+    SaveFile save(path);
+    if (!save.Valid()) {
+      error = "invalid save file";
+      return false;
+    }
+    BoardFromSave(save, state);
+  } else {
+    std::ifstream file(path);
+    if (!file) {
+      error = "file could not be opened";
+      return false;
+    }
+    if (!ParseBoardText(file, state, error)) {
+      return false;
+    }
+  }
+  return ValidateBoard(state, error);
+}
+
+/**
+ * @brief Builds a board from a file path or a generator specification.
+ *
+ * @param spec Path, "serpentine:WxH" or "tangled:WxH".
+ * @param state Receives the state.
+ * @param error Receives the reason on failure.
+ * @return true if a valid state was built.
+ */
+bool MakeBoard(const std::string &spec, BoardState &state, std::string &error) {
+  const std::size_t colon = spec.find(':');
+  const std::string generator = colon == std::string::npos ? "" : spec.substr(0, colon);
+  if (generator != "serpentine" && generator != "tangled") {
+    return LoadBoard(spec, state, error);
+  }
+
+  int width = 0;
+  int height = 0;
+  if (!ParseSize(spec.substr(colon + 1), width, height)) {
+    error = "expected " + generator + ":WxH with sides of at most " + std::to_string(kMaxGridSide);
+    return false;
+  }
+  if (width < 3 || height < 3) {
+    error = "grid too small for " + generator;
+    return false;
+  }
+  state = generator == "serpentine" ? SerpentineBoard(width, height) : TangledBoard(width, height);
+  return ValidateBoard(state, error);
+}
+
+/**
+ * @brief Generates a snake that fills the grid row by row in alternating directions, leaving a row free.
+ *
+ * @param grid_width Width of the grid.
+ * @param grid_height Height of the grid.
+ * @return BoardState The generated state.
+ */
+BoardState SerpentineBoard(int grid_width, int grid_height) {
+  std::vector<SDL_Point> path;
+  path.reserve(static_cast<std::size_t>(grid_width) * grid_height);
+  for (int y = 0; y < grid_height; ++y) {
+    for (int i = 0; i < grid_width; ++i) {
+      path.push_back(SDL_Point{y % 2 == 0 ? i : grid_width - 1 - i, y});
+    }
+  }
+  return FromPath(std::move(path), grid_width, grid_height);
+}
+
+/**
+ * @brief Generates a snake that turns at every segment within each band of two rows.
+ *
+ * Within a band, each column is crossed vertically, alternating downwards and upwards, and the path
+ * steps sideways between columns. With an odd number of columns the band ends on its lower row, right
+ * above the first cell of the next band, which runs in the opposite direction.
+ *
+ * @param grid_width Width of the grid.
+ * @param grid_height Height of the grid.
+ * @return BoardState The generated state.
+ */
+BoardState TangledBoard(int grid_width, int grid_height) {
+  const int columns = grid_width % 2 == 1 ? grid_width : grid_width - 1;
+  const int bands = grid_height / 2;
+  std::vector<SDL_Point> path;
+  path.reserve(static_cast<std::size_t>(columns) * bands * 2);
+  for (int band = 0; band < bands; ++band) {
+    const int top = 2 * band;
+    for (int i = 0; i < columns; ++i) {
+      const int x = band % 2 == 0 ? i : columns - 1 - i;
+      const bool downwards = i % 2 == 0;
+      path.push_back(SDL_Point{x, downwards ? top : top + 1});
+      path.push_back(SDL_Point{x, downwards ? top + 1 : top});
+    }
+  }
+  return FromPath(std::move(path), grid_width, grid_height);
+}
@@ -0,0 +1,127 @@
+#ifndef BOARDSTATE_H
+#define BOARDSTATE_H
+
+#include <istream>
+#include <string>
+#include <vector>
+#include "SDL.h"
+#include "snake.h"
+
+/**
+ * @brief Largest grid width and height a board may have.
+ *
+ * Head positions are kept in steps of 1/Snake::kPositionScale cells in a float, which has room for 2^24
+ * such steps, i.e. positions below 4096 cells. Snake moves and wraps the head in whole steps, so the float
+ * only ever holds a position inside the grid, never a sum such as the head plus the grid width.
+ */
+constexpr int kMaxGridSide = 4096;
+
+/**
+ * @brief A complete game position that can be built directly, without playing up to it.
+ *
+ * Used to start games, benchmarks and headless runs from arbitrary boards, e.g. with a snake of a
+ * million cells. A state is only adopted after ValidateBoard accepted it.
+ */
+struct BoardState {
+  int grid_width{32};                                 ///< Width of the game grid.
+  int grid_height{32};                                ///< Height of the game grid.
+  float head_x{16.0f};                                ///< Head position; the integer part is the head's cell.
+  float head_y{16.0f};
+  std::vector<SDL_Point> body;                        ///< Body cells from the segment behind the head to the tail.
+  Snake::Direction direction{Snake::Direction::kUp};  ///< Movement direction.
+  float speed{10.0f};                                 ///< Speed in cells per second.
+  bool growing{false};                                ///< Whether the snake grows on its next move.
+  int score{0};                                       ///< Score of the game.
+  SDL_Point food{0, 0};                               ///< Food position.
+};
+
+/**
+ * @brief Checks that a state could occur in a game.
+ *
+ * The grid must be non-empty and at most kMaxGridSide cells per side, and everything must lie on it; the body must be a connected path of
+ * distinct cells starting next to the head, with wrapping at the edges; the snake must not be heading
+ * into the segment behind its head; the food must be on a free cell; the speed must be positive.
+ *
+ * @param state State to check.
+ * @param error Receives the reason if the state is invalid.
+ * @return true if the state is valid.
+ */
+bool ValidateBoard(const BoardState &state, std::string &error);
+
+/**
+ * @brief Parses a board in the text format.
+ *
+ * One keyword per line, '#' starts a comment:
+ *
+ *     grid 32 32
+ *     head 16 16
+ *     body 16 17 16 18      # x y pairs, behind the head first; may be repeated
+ *     direction up          # up, down, left or right
+ *     speed 10
+ *     score 2
+ *     growing 0
+ *     food 3 4
+ *
+ * Omitted keywords keep the defaults of BoardState.
+ *
+ * @param in Stream to read.
+ * @param state Receives the parsed state.
+ * @param error Receives the reason if parsing failed.
+ * @return true if the text was parsed; the state still has to be validated.
+ */
+bool ParseBoardText(std::istream &in, BoardState &state, std::string &error);
+
+class SaveFile;
+
+/**
+ * @brief Copies the game position of a save file into a state.
+ *
+ * @param save Save file whose header passed the save file checks.
+ * @param state Receives the state; it still has to be validated.
+ */
+void BoardFromSave(const SaveFile &save, BoardState &state);
+
+/**
+ * @brief Loads a board from a file, either a save file written by --save or the text format.
+ *
+ * @param path File to load.
+ * @param state Receives the state.
+ * @param error Receives the reason if loading or validation failed.
+ * @return true if a valid state was loaded.
+ */
+bool LoadBoard(const std::string &path, BoardState &state, std::string &error);
+
+/**
+ * @brief Builds a board from a specification: a file path, or a generator as "serpentine:WxH" or "tangled:WxH".
+ *
+ * @param spec Path or generator specification.
+ * @param state Receives the state.
+ * @param error Receives the reason on failure.
+ * @return true if a valid state was built.
+ */
+bool MakeBoard(const std::string &spec, BoardState &state, std::string &error);
+
+/**
+ * @brief Generates a snake that fills the grid row by row in alternating directions.
+ *
+ * Only a row's worth of cells is left free at the start of the path, one of which holds the food.
+ *
+ * @param grid_width Width of the grid.
+ * @param grid_height Height of the grid.
+ * @return BoardState The generated state.
+ */
+BoardState SerpentineBoard(int grid_width, int grid_height);
+
+/**
+ * @brief Generates a snake that turns at every segment, as densely packed as the grid allows.
+ *
+ * The path runs through bands of two rows as a square wave, so every segment is a corner. Bands use an
+ * odd number of columns so that each band ends on its lower row, next to the start of the following band.
+ *
+ * @param grid_width Width of the grid; at least 3.
+ * @param grid_height Height of the grid; at least 3.
+ * @return BoardState The generated state.
+ */
+BoardState TangledBoard(int grid_width, int grid_height);
+
+#endif // BOARDSTATE_H
@@ -1,26 +1,9 @@
 #include "controller.h"
 #include <iostream>
 #include "SDL.h"
+#include "gamerules.h"
 #include "snake.h"
 
-/**
- * @brief Changes the direction of the snake to the input direction unless it's the opposite of the current direction.
- * 
- * The snake's direction will only change if the input direction is not the opposite of the current direction,
- * except when the snake has only one segment, in which case it can turn back on itself.
- * 
- * @param snake Reference to the Snake object whose direction needs to be changed.
- * @param input The desired new direction for the snake.
- * @param opposite The direction opposite to the current direction of the snake.
- */
-void Controller::ChangeDirection(Snake &snake, Snake::Direction input,
-                                 Snake::Direction opposite) const {
-  if (snake.direction != opposite || snake.size == 1) {
-    snake.direction = input;
-  }
-  return;
-}
-
 /**
  * @brief Processes input events from SDL and applies game controls.
  * 
@@ -36,27 +19,36 @@ void Controller::HandleInput(bool &running, Snake &snake) const {
     if (e.type == SDL_QUIT) {
       running = false;
     } else if (e.type == SDL_KEYDOWN) {
+      bool changed = false;
       switch (e.key.keysym.sym) {
         case SDLK_UP:
-          ChangeDirection(snake, Snake::Direction::kUp,
-                          Snake::Direction::kDown);
+          changed = GameRules::Turn(snake, Snake::Direction::kUp);
           break;
 
         case SDLK_DOWN:
-          ChangeDirection(snake, Snake::Direction::kDown,
-                          Snake::Direction::kUp);
+          changed = GameRules::Turn(snake, Snake::Direction::kDown);
           break;
 
         case SDLK_LEFT:
-          ChangeDirection(snake, Snake::Direction::kLeft,
-                          Snake::Direction::kRight);
+          changed = GameRules::Turn(snake, Snake::Direction::kLeft);
           break;
 
         case SDLK_RIGHT:
-          ChangeDirection(snake, Snake::Direction::kRight,
-                          Snake::Direction::kLeft);
+          changed = GameRules::Turn(snake, Snake::Direction::kRight);
           break;
       }
+      if (changed && latency_probe) {
+        latency_probe->OnInput(e.key.timestamp, snake.direction);
+      }
     }
   }
 }
+
+/**
+ * @brief Sets the latency probe notified of handled direction changes.
+ * 
+ * @param probe Probe to notify, or nullptr to stop reporting.
+ */
+void Controller::AttachLatencyProbe(LatencyProbe *probe) {
+  latency_probe = probe;
+}
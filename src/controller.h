@@ -2,6 +2,7 @@
 #define CONTROLLER_H
 
 #include "snake.h"
+#include "latencyprobe.h"
 
 /**
  * @brief Class to handle input controls for the snake game.
@@ -20,20 +21,15 @@ class Controller {
    */
   void HandleInput(bool &running, Snake &snake) const;
 
- private:
   /**
-   * @brief Change the direction of the snake based on user input.
-   * 
-   * This method ensures that the snake does not reverse on itself and only changes
-   * direction to valid new directions.
+   * @brief Report handled direction changes to a latency probe.
    * 
-   * @param snake Reference to the Snake object whose direction is to be changed.
-   * @param input The new direction inputted by the user.
-   * @param opposite The opposite direction of the current direction of the snake.
-   *                 Used to prevent the snake from reversing on itself.
+   * @param probe Probe to notify, or nullptr to stop reporting. The probe must outlive the controller's use of it.
    */
-  void ChangeDirection(Snake &snake, Snake::Direction input,
-                       Snake::Direction opposite) const;
+  void AttachLatencyProbe(LatencyProbe *probe);
+
+ private:
+  LatencyProbe *latency_probe{nullptr}; ///< Optional probe notified of handled direction changes.
 };
 
 #endif // CONTROLLER_H
@@ -1,8 +1,14 @@
 #include "game.h"
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
+#include <string>
 #include <chrono>
+#include <cmath>
 #include <thread>
 #include "SDL.h"
+#include "tracer.h"
+#include "metrics.h"
 
 /**
  * @brief Constructs a new Game object and initializes the game state including the snake, food placement, and RNG.
@@ -14,11 +20,12 @@
  */
 Game::Game(std::size_t grid_width, std::size_t grid_height)
     : snake(grid_width, grid_height),
+      renderSnake(grid_width, grid_height),
       gameOverHandler(std::make_unique<GameOverHandler>()),
-      random_w(0, static_cast<int>(grid_width - 1)),
-      random_h(0, static_cast<int>(grid_height - 1)), 
+      rules(static_cast<int>(grid_width), static_cast<int>(grid_height)),
       engine(dev()),
       running(true) {
+  Metrics::Instance().games_total.fetch_add(1, std::memory_order_relaxed);
   PlaceFood();
   // Initiates the thread that handles snake updates based on a fixed time interval.
   snakeThread = std::make_unique<std::thread>(&Game::ThreadedUpdate, this);
@@ -30,8 +37,16 @@ Game::Game(std::size_t grid_width, std::size_t grid_height)
  * Ensures that all resources are properly released and all threads are terminated safely before the game object is destroyed.
  */
 Game::~Game() {
+  StopThreads();
+  Cleanup();
+}
+
+/**
+ * @brief Stops the snake thread and waits for it and the game over thread to finish.
+ */
+void Game::StopThreads() {
   {
-    std::lock_guard<std::mutex> lock(mtx);
+    std::lock_guard<ProfiledMutex> lock(mtx);
     running = false;
     cv.notify_all(); // Notify the thread to stop waiting and exit
   }
@@ -43,8 +58,6 @@ Game::~Game() {
   if (gameOverThread.joinable()) {
     gameOverThread.join();
   }
-
-  Cleanup();
 }
 
 /**
@@ -53,6 +66,27 @@ Game::~Game() {
  * This function is responsible for releasing all SDL-related resources to prevent resource leaks.
  */
 void Game::Cleanup() {
+  TRACE_FLUSH();
+  LOCK_PROFILE_REPORT(std::cout);
+  if (latencyProbe) {
+    latencyProbe->Report(std::cout);
+  }
+  if (simSpeed != 1.0) {
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+    double sim_s = simTimeUs.load(std::memory_order_relaxed) / 1e6;
+    std::cout << std::fixed << std::setprecision(1) << "Simulated " << sim_s << " s in " << wall_s << " s: "
+              << (wall_s > 0.0 ? sim_s / wall_s : 0.0) << "x real time (requested ";
+    if (std::isinf(simSpeed)) {
+      std::cout << "max";
+    } else {
+      std::cout << simSpeed << "x";
+    }
+    std::cout << ")\n";
+  }
+  if (saveWriter) {
+    saveWriter->Discard(); // The game ended normally, there is nothing to resume
+    saveWriter.reset();
+  }
   SDL_Quit();
 }
 
@@ -70,34 +104,99 @@ void Game::Run(std::unique_ptr<Controller> controller, std::unique_ptr<Renderer>
                std::size_t target_frame_duration) {
   Uint32 title_timestamp = SDL_GetTicks();
   int frame_count = 0;
+  TRACE_THREAD_NAME("main");
+  controller->AttachLatencyProbe(latencyProbe.get());
+  renderer->SetFrameBudget(target_frame_duration);
+  Metrics &metrics = Metrics::Instance();
+  auto previous_frame = std::chrono::steady_clock::now();
+  runStart = previous_frame;
+  std::uint64_t title_sim_us = simTimeUs.load(std::memory_order_relaxed);
 
   while (running) {
+      TRACE_SCOPE("Game::Run");
       Uint32 frame_start = SDL_GetTicks();
+      auto frame_begin = std::chrono::steady_clock::now();
+      metrics.frame_time_us.Record(std::chrono::duration_cast<std::chrono::microseconds>(frame_begin - previous_frame).count());
+      previous_frame = frame_begin;
 
+      if (latencyProbe) {
+          latencyProbe->InjectDue();
+      }
       controller->HandleInput(running, snake);
-      renderer->Render(snake, food);
+      {
+          // Take a consistent snapshot to render: the sprite ring is updated from the snake's move counter and must
+          // not see a move half applied. Only the cells entered since the last frame are copied, so the snake
+          // thread is held up briefly, not for the whole render.
+          std::lock_guard<ProfiledMutex> lock(mtx);
+          renderSnake.Mirror(snake);
+          renderFood = food;
+          if (latencyProbe) {
+              latencyProbe->OnFrameStart();
+          }
+      }
+      auto render_begin = std::chrono::steady_clock::now();
+      renderer->Render(renderSnake, renderFood);
+      metrics.render_time_us.Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - render_begin).count());
+      metrics.frames_total.fetch_add(1, std::memory_order_relaxed);
+      if (latencyProbe) {
+          latencyProbe->OnFramePresented();
+          if (latencyProbe->Finished()) {
+              running = false;
+          }
+      }
+      if (soakMonitor) {
+          soakMonitor->SampleDue();
+          if (soakMonitor->Finished()) {
+              running = false;
+          }
+      }
 
       Uint32 frame_end = SDL_GetTicks();
       frame_count++;
       Uint32 frame_duration = frame_end - frame_start;
 
       if (frame_end - title_timestamp >= 1000) {
-          renderer->UpdateWindowTitle(score, frame_count);
+          std::uint64_t sim_us = simTimeUs.load(std::memory_order_relaxed);
+          double achieved_speed = (sim_us - title_sim_us) / 1000.0 / (frame_end - title_timestamp);
+          title_sim_us = sim_us;
+          renderer->UpdateWindowTitle(score, frame_count, simSpeed != 1.0 ? achieved_speed : 0.0);
+          metrics.fps.store(frame_count, std::memory_order_relaxed);
           frame_count = 0;
           title_timestamp = frame_end;
+
+          if (saveWriter) {
+              ProfiledUniqueLock lock(mtx);
+              if (snake.alive) {
+                  BuildSaveImage(snake, food, score, engine, saveImage);
+                  lock.unlock();
+                  saveWriter->Submit(saveImage);
+              }
+          }
       }
 
       if (frame_duration < target_frame_duration) {
+          TRACE_SCOPE("SDL_Delay");
           SDL_Delay(target_frame_duration - frame_duration);
       }
 
       if (!snake.alive && !gameOverThread.joinable()) {
+          if (saveWriter) {
+              saveWriter->Discard();
+          }
           gameOverThread = std::thread(&Game::HandleGameOver, this);
       }
       if (gameOverThread.joinable()) {
           gameOverThread.join();
       }
   }
+
+  // The renderer quits SDL when it goes out of scope below, so the audio device has to be closed first,
+  // and nothing may trigger an effect anymore.
+  StopThreads();
+  if (audio) {
+    audio->Report(std::cout);
+    audio.reset();
+  }
 }
 
 /**
@@ -106,14 +205,8 @@ void Game::Run(std::unique_ptr<Controller> controller, std::unique_ptr<Renderer>
  * This method ensures that the food does not appear on any part of the snake's body.
  */
 void Game::PlaceFood() {
-  int x, y;
-  do {
-    x = random_w(engine);
-    y = random_h(engine);
-  } while (snake.SnakeCell(x, y));
-
-  food.x = x;
-  food.y = y;
+  TRACE_SCOPE("Game::PlaceFood");
+  rules.PlaceFood(snake, engine, food);
 }
 
 /**
@@ -123,6 +216,7 @@ void Game::PlaceFood() {
  * initialized for a new game session.
  */
 void Game::ResetGame() {
+    TRACE_SCOPE("Game::ResetGame");
     {
       running = false;
       cv.notify_all(); // Notify the thread to stop waiting and exit
@@ -136,6 +230,11 @@ void Game::ResetGame() {
     score = 0;
     PlaceFood();
 
+    Metrics &metrics = Metrics::Instance();
+    metrics.games_total.fetch_add(1, std::memory_order_relaxed);
+    metrics.score.store(score, std::memory_order_relaxed);
+    metrics.snake_size.store(snake.size, std::memory_order_relaxed);
+
     running = true;
     snake.alive = true;
 
@@ -149,8 +248,10 @@ void Game::ResetGame() {
  * for a smooth transition between game over and restart scenarios.
  */
 void Game::HandleGameOver() {
-  std::lock_guard<std::mutex> lock(mtx);
-  if (gameOverHandler->ShowGameOverMessage(score)) {
+  TRACE_THREAD_NAME("gameOverThread");
+  TRACE_SCOPE("Game::HandleGameOver");
+  std::lock_guard<ProfiledMutex> lock(mtx);
+  if (autoPilot || gameOverHandler->ShowGameOverMessage(score)) {
     ResetGame();
   } else {
     running = false;
@@ -169,34 +270,248 @@ int Game::GetScore() const { return score; }
  */
 int Game::GetSize() const { return snake.size; }
 
+/**
+ * @brief Enables input-to-photon latency measurement for the next call to Run.
+ * 
+ * @param injected_keys Number of synthetic key presses to inject, 0 to measure real input only.
+ */
+void Game::EnableLatencyMeasurement(int injected_keys) {
+  std::lock_guard<ProfiledMutex> lock(mtx);
+  latencyProbe = std::make_unique<LatencyProbe>(injected_keys);
+}
+
+/**
+ * @brief Turns the next call to Run into an unattended soak run.
+ * 
+ * @param config Duration, sampling interval and growth threshold of the run.
+ */
+void Game::EnableSoak(const SoakConfig &config) {
+  std::lock_guard<ProfiledMutex> lock(mtx);
+  autoPilot = std::make_unique<AutoPilot>();
+  soakMonitor = std::make_unique<SoakMonitor>(config);
+}
+
+/**
+ * @brief Opens the audio device and enables sound effects for simulation events.
+ * 
+ * Taken under the game mutex, since the snake thread is already running and reads the pointer.
+ */
+void Game::EnableAudio() {
+  std::lock_guard<ProfiledMutex> lock(mtx);
+  audio = std::make_unique<AudioSystem>();
+}
+
+/**
+ * @brief Lets the AutoPilot steer the snake and restart games, for spectating AI games.
+ */
+void Game::EnableAutoPilot() {
+  std::lock_guard<ProfiledMutex> lock(mtx);
+  autoPilot = std::make_unique<AutoPilot>();
+}
+
+/**
+ * @brief Sets the multiple of real time the simulation runs at.
+ * 
+ * @param speed Multiple of real time, or infinity to simulate as fast as possible.
+ */
+void Game::SetSimSpeed(double speed) {
+  std::lock_guard<ProfiledMutex> lock(mtx);
+  simSpeed = speed;
+  cv.notify_all(); // Wake the snake thread so the new pacing applies immediately
+}
+
+/**
+ * @brief Continues a saved game instead of the fresh one.
+ * 
+ * The header was checked in constant time when the file was mapped. Copying the body out of the mapping,
+ * validating it against a map of the grid and adopting it are each linear in the body length, and the
+ * validation also in the grid size.
+ * 
+ * @param save Save file whose header passed the save file checks.
+ * @return true if the save was adopted; false if it was made for a different grid or holds an invalid game.
+ */
+bool Game::Resume(const SaveFile &save) {
+  const SaveHeader &header = save.Header();
+  if (header.grid_width != snake.GetGridWidth() || header.grid_height != snake.GetGridHeight()) {
+    std::cerr << "Save file is for a " << header.grid_width << "x" << header.grid_height
+              << " grid, starting a new game.\n";
+    return false;
+  }
+
+  // The header checks only cover the layout of the file; the position itself must be playable too.
+  BoardState state;
+  BoardFromSave(save, state);
+  std::string error;
+  if (!ValidateBoard(state, error)) {
+    std::cerr << "Save file holds an invalid game (" << error << "), starting a new game.\n";
+    return false;
+  }
+
+  std::mt19937 saved_engine;
+  save.RestoreEngine(saved_engine);
+  Adopt(state.head_x, state.head_y, state.direction, state.speed, state.growing, state.body.data(),
+        state.body.size(), state.food, state.score, &saved_engine);
+  return true;
+}
+
+/**
+ * @brief Replaces the current game with an arbitrary validated board.
+ * 
+ * @param state Board to play on; must have passed ValidateBoard.
+ * @return true if the board was adopted; false if it was made for a different grid.
+ */
+bool Game::LoadBoard(const BoardState &state) {
+  if (state.grid_width != snake.GetGridWidth() || state.grid_height != snake.GetGridHeight()) {
+    std::cerr << "Board is for a " << state.grid_width << "x" << state.grid_height << " grid, starting a new game.\n";
+    return false;
+  }
+  Adopt(state.head_x, state.head_y, state.direction, state.speed, state.growing, state.body.data(),
+        state.body.size(), state.food, state.score, nullptr);
+  return true;
+}
+
+/**
+ * @brief Stops the snake thread, replaces the game state and restarts the thread.
+ * 
+ * Follows the stop, mutate, restart sequence of ResetGame. The body is copied in one bulk assignment;
+ * everything else is a fixed number of fields.
+ */
+void Game::Adopt(float head_x, float head_y, Snake::Direction direction, float speed, bool growing,
+                 const SDL_Point *body, std::size_t length, const SDL_Point &new_food, int new_score,
+                 const std::mt19937 *new_engine) {
+  {
+    std::lock_guard<ProfiledMutex> lock(mtx);
+    running = false;
+    cv.notify_all(); // Notify the thread to stop waiting and exit
+  }
+  if (snakeThread && snakeThread->joinable()) {
+    snakeThread->join();
+  }
+
+  snake.Adopt(head_x, head_y, direction, speed, growing, body, length);
+  food = new_food;
+  score = new_score;
+  if (new_engine) {
+    engine = *new_engine;
+  }
+
+  Metrics &metrics = Metrics::Instance();
+  metrics.score.store(score, std::memory_order_relaxed);
+  metrics.snake_size.store(snake.size, std::memory_order_relaxed);
+
+  running = true;
+  snakeThread = std::make_unique<std::thread>(&Game::ThreadedUpdate, this);
+}
+
+/**
+ * @brief Starts the background writer that saves the game once per second.
+ * 
+ * @param path Path of the save file.
+ */
+void Game::EnableSaving(const std::string &path) {
+  std::lock_guard<ProfiledMutex> lock(mtx);
+  saveWriter = std::make_unique<SaveWriter>(path);
+}
+
+/**
+ * @brief Prints the soak trend report and returns whether the run passed.
+ * 
+ * @return true if no sampled metric trended upward beyond the threshold, or if no soak was run.
+ */
+bool Game::SoakPassed() const {
+  return !soakMonitor || soakMonitor->Evaluate(std::cout);
+}
+
 /**
  * @brief The function updates the snake based on elapsed time to ensure smooth movement across varying frame rates.
  * 
  * This thread is crucial for maintaining consistent game physics and responsiveness by adjusting the snake's position
  * based on the time elapsed since the last update.
+ * 
+ * At real-time speed each tick advances the simulation by the elapsed wall time. At any other speed the thread
+ * owes the elapsed wall time multiplied by the speed, and pays it off in fixed steps of one tick interval. A batch
+ * of steps holds the mutex for at most kBatchBudget before the lock is released again, so input, rendering and the
+ * game over handling stay responsive even at the highest speeds. A backlog of more than kMaxBacklog of wall time is
+ * dropped rather than caught up, which shows up as a lower achieved speed.
  */
 void Game::ThreadedUpdate() {
+  TRACE_THREAD_NAME("snakeThread");
+  constexpr auto kTickInterval = std::chrono::milliseconds(10);
+  constexpr auto kBatchBudget = std::chrono::milliseconds(1);
+  constexpr auto kYield = std::chrono::microseconds(100);
+  constexpr double kMaxBacklog = 0.25; // Seconds of wall time
+  constexpr float kStep = std::chrono::duration<float>(kTickInterval).count();
+  Metrics &metrics = Metrics::Instance();
   auto lastUpdateTime = std::chrono::steady_clock::now();
+  Snake::Direction lastMoveDirection = snake.direction;
+  double owed = 0.0; // Simulated seconds not yet stepped
+  std::chrono::microseconds wait = kTickInterval;
 
   while (running && snake.alive) {
-      std::unique_lock<std::mutex> lock(mtx);
-      cv.wait_for(lock, std::chrono::milliseconds(10), [this]() { return !running || !snake.alive; });
+      ProfiledUniqueLock lock(mtx);
+      cv.wait_for(lock, wait, [this]() { return !running || !snake.alive; });
       
       if (!running || !snake.alive) break;
+      TRACE_SCOPE("Game::ThreadedUpdate");
 
       auto currentTime = std::chrono::steady_clock::now();
       float elapsed_time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - lastUpdateTime).count();
+      auto jitter = std::chrono::duration_cast<std::chrono::microseconds>(currentTime - lastUpdateTime - kTickInterval).count();
       lastUpdateTime = currentTime;
 
-      snake.Update(elapsed_time);
+      if (simSpeed == 1.0) {
+          metrics.tick_jitter_us.Record(jitter < 0 ? -jitter : jitter);
+          Step(elapsed_time, lastMoveDirection);
+          wait = kTickInterval;
+          continue;
+      }
 
-      int new_x = static_cast<int>(snake.head_x);
-      int new_y = static_cast<int>(snake.head_y);
-      if (food.x == new_x && food.y == new_y) {
-          score++;
-          PlaceFood();
-          snake.GrowBody();
-          snake.IncreaseSpeed();
+      owed = std::isinf(simSpeed) ? simSpeed : std::min(owed + elapsed_time * simSpeed, kMaxBacklog * simSpeed);
+      while (owed >= kStep && running && snake.alive &&
+             std::chrono::steady_clock::now() - currentTime < kBatchBudget) {
+          Step(kStep, lastMoveDirection);
+          owed -= kStep;
+      }
+      if (owed >= kStep) {
+          wait = kYield;
+      } else {
+          wait = std::min<std::chrono::microseconds>(
+              kTickInterval, std::chrono::microseconds(static_cast<long>((kStep - owed) / simSpeed * 1e6) + 1));
       }
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Advances the snake by one step and applies what happened: eating, growing, dying and sound effects.
+ * 
+ * @param elapsed_time Simulated time of the step in seconds.
+ * @param lastMoveDirection Direction of the last move between cells, updated when the head enters a new cell.
+ */
+void Game::Step(float elapsed_time, Snake::Direction &lastMoveDirection) {
+  Metrics &metrics = Metrics::Instance();
+  metrics.sim_ticks_total.fetch_add(1, std::memory_order_relaxed);
+  simTimeUs.fetch_add(static_cast<std::uint64_t>(elapsed_time * 1e6f), std::memory_order_relaxed);
+
+  GameRules::StepResult result = rules.Step(snake, food, score, engine, elapsed_time, autoPilot.get());
+  if (latencyProbe && result.moved) {
+      latencyProbe->OnSimMove(result.direction);
+  }
+  if (audio && result.moved) {
+      if (!snake.alive) {
+          audio->Play(AudioSystem::Effect::kDeath);
+      } else if (result.direction != lastMoveDirection) {
+          audio->Play(AudioSystem::Effect::kTurn);
+      }
+  }
+  if (result.moved) {
+      lastMoveDirection = result.direction;
+  }
+
+  if (result.ate) {
+      metrics.score.store(score, std::memory_order_relaxed);
+      if (audio) {
+          audio->Play(AudioSystem::Effect::kEat);
+      }
+  }
+  metrics.snake_size.store(snake.size, std::memory_order_relaxed);
+}
@@ -1,6 +1,8 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <atomic>
+#include <cstdint>
 #include <random>
 #include <memory>
 #include <thread>
@@ -12,6 +14,14 @@
 #include "renderer.h"
 #include "snake.h"
 #include "gameoverhandler.h"
+#include "lockprofiler.h"
+#include "latencyprobe.h"
+#include "autopilot.h"
+#include "soakmonitor.h"
+#include "audio.h"
+#include "savegame.h"
+#include "boardstate.h"
+#include "gamerules.h"
 
 /**
  * @brief Manages the main game loop, interactions, and state management for a snake game.
@@ -68,26 +78,124 @@ public:
    */
   int GetSize() const;
 
+  /**
+   * @brief Enables input-to-photon latency measurement for the next call to Run.
+   * 
+   * The latency distribution is printed when the game shuts down.
+   * 
+   * @param injected_keys Number of synthetic key presses to inject. When non-zero, Run returns once
+   *                      all of them have been measured.
+   */
+  void EnableLatencyMeasurement(int injected_keys);
+
+  /**
+   * @brief Turns the next call to Run into a soak run.
+   * 
+   * The snake is steered by an AutoPilot, games restart through ResetGame without asking the player,
+   * and resource usage and timing are sampled until the configured duration has elapsed.
+   * 
+   * @param config Duration, sampling interval and growth threshold of the run.
+   */
+  void EnableSoak(const SoakConfig &config);
+
+  /**
+   * @brief Enables sound effects for eating, turning and dying.
+   * 
+   * Effects are triggered by the simulation thread at the moment the event happens in the simulation.
+   */
+  void EnableAudio();
+
+  /**
+   * @brief Lets the AutoPilot steer the snake and restarts games without asking, for spectating AI games.
+   */
+  void EnableAutoPilot();
+
+  /**
+   * @brief Runs the simulation at a multiple of real time, decoupled from the display.
+   * 
+   * Any speed other than 1 switches the snake thread to fixed simulation steps of one tick, run in
+   * short batches so that input handling and rendering are never held up for long. Rendering stays
+   * at display rate and always shows the latest state; intermediate states are skipped.
+   * 
+   * @param speed Multiple of real time, or infinity to simulate as fast as possible.
+   */
+  void SetSimSpeed(double speed);
+
+  /**
+   * @brief Continues a saved game instead of the fresh one.
+   * 
+   * The saved position is checked with ValidateBoard first. Stops the snake thread, adopts the saved
+   * state and restarts the thread, like ResetGame does. Takes time linear in the body length plus the
+   * grid size; only the header checks are constant time.
+   * 
+   * @param save Save file whose header passed the save file checks.
+   * @return true if the save was adopted; false if it was made for a different grid or holds an invalid game.
+   */
+  bool Resume(const SaveFile &save);
+
+  /**
+   * @brief Replaces the current game with an arbitrary validated board.
+   * 
+   * @param state Board to play on; must have passed ValidateBoard and match the game's grid.
+   * @return true if the board was adopted; false if it was made for a different grid.
+   */
+  bool LoadBoard(const BoardState &state);
+
+  /**
+   * @brief Saves the game to a file once per second, from a background thread.
+   * 
+   * The file is removed when the game ends normally, so only an interrupted game is resumed.
+   * 
+   * @param path Path of the save file.
+   */
+  void EnableSaving(const std::string &path);
+
+  /**
+   * @brief Prints the soak trend report and returns whether the run passed.
+   * 
+   * @return true if no sampled metric trended upward beyond the threshold, or if no soak was run.
+   */
+  bool SoakPassed() const;
+
 private:
   Snake snake; ///< Handles the behavior and state of the snake.
+  Snake renderSnake; ///< Copy of the snake the main thread renders from, updated under mtx once per frame.
   std::unique_ptr<GameOverHandler> gameOverHandler; ///< Manages game over scenarios.
   std::thread gameOverThread; ///< Thread for processing game over logic asynchronously.
-  std::mutex mtx; ///< Mutex for synchronizing access to shared resources.
+  ProfiledMutex mtx{"Game::mtx"}; ///< Mutex for synchronizing access to shared resources.
   SDL_Point food; ///< Current position of the food on the grid.
+  SDL_Point renderFood; ///< Copy of the food position taken with renderSnake.
   std::random_device dev; ///< Device used to generate seeds for the random number generator.
-  std::uniform_int_distribution<int> random_w; ///< Distribution for randomizing food's horizontal position.
-  std::uniform_int_distribution<int> random_h; ///< Distribution for randomizing food's vertical position.
+  GameRules rules; ///< Step rules and food placement, shared with the headless simulator.
   std::mt19937 engine; ///< Random number generator.
-  std::condition_variable cv; ///< Condition variable for synchronizing the snake update thread.
+  ProfiledConditionVariable cv; ///< Condition variable for synchronizing the snake update thread.
 
 
   std::unique_ptr<std::thread> snakeThread; ///< Thread for continuously updating the game state.
+  std::unique_ptr<LatencyProbe> latencyProbe; ///< Latency probe, only set in measurement mode.
+  std::unique_ptr<AutoPilot> autoPilot; ///< Steers the snake instead of the player, only set in soak mode.
+  std::unique_ptr<SoakMonitor> soakMonitor; ///< Samples drift metrics, only set in soak mode.
+  std::unique_ptr<AudioSystem> audio; ///< Sound effects, unset when muted.
+  std::unique_ptr<SaveWriter> saveWriter; ///< Writes the periodic saves, only set when saving is enabled.
+  std::vector<unsigned char> saveImage; ///< Buffer the next save is built in, reused between saves.
 
   bool running{true}; ///< Indicates whether the game loop is active.
+  double simSpeed{1.0}; ///< Requested multiple of real time, infinity for as fast as possible.
+  std::atomic<std::uint64_t> simTimeUs{0}; ///< Simulated time advanced by the snake thread, in microseconds.
+  std::chrono::steady_clock::time_point runStart; ///< Wall time at which Run started.
 
   int score{0}; ///< Tracks the number of points scored by the player.
 
   void ThreadedUpdate(); ///< Updates the game state in a dedicated thread.
+  void StopThreads(); ///< Stops the snake thread and joins it and the game over thread.
+
+  /**
+   * @brief Advances the simulation by one step. Must be called with mtx held.
+   * 
+   * @param elapsed_time Simulated time of the step in seconds.
+   * @param lastMoveDirection Direction of the last move between cells, updated when the head enters a new cell.
+   */
+  void Step(float elapsed_time, Snake::Direction &lastMoveDirection);
 
   /**
    * @brief Randomly places food on the grid where it is not occupied by the snake.
@@ -106,6 +214,16 @@ private:
    */
   void ResetGame();
 
+  /**
+   * @brief Stops the snake thread, replaces the game state and restarts the thread.
+   * 
+   * Shared by Resume and LoadBoard; follows the sequence of ResetGame. Must not be called with mtx held.
+   * The food RNG is replaced too if new_engine is not nullptr.
+   */
+  void Adopt(float head_x, float head_y, Snake::Direction direction, float speed, bool growing,
+             const SDL_Point *body, std::size_t length, const SDL_Point &new_food, int new_score,
+             const std::mt19937 *new_engine);
+
   /**
    * @brief Manages the game over process in a separate thread to avoid blocking the main game loop.
    * 
@@ -0,0 +1,125 @@
+#include "gamerules.h"
+
+/**
+ * @brief Construct a new GameRules object.
+ *
+ * @param grid_width Width of the game grid.
+ * @param grid_height Height of the game grid.
+ */
+GameRules::GameRules(int grid_width, int grid_height)
+    : grid_width(grid_width),
+      grid_height(grid_height),
+      random_w(0, grid_width - 1),
+      random_h(0, grid_height - 1) {}
+
+/**
+ * @brief Returns the direction that reverses the given one.
+ */
+Snake::Direction GameRules::Opposite(Snake::Direction direction) {
+  switch (direction) {
+    case Snake::Direction::kUp: return Snake::Direction::kDown;
+    case Snake::Direction::kDown: return Snake::Direction::kUp;
+    case Snake::Direction::kLeft: return Snake::Direction::kRight;
+    case Snake::Direction::kRight: return Snake::Direction::kLeft;
+  }
+  return direction;
+}
+
+/**
+ * @brief Returns true if the direction differs from the current one and does not reverse a snake with a body.
+ */
+bool GameRules::CanTurn(const Snake &snake, Snake::Direction direction) {
+  return direction != snake.direction && (direction != Opposite(snake.direction) || snake.size == 1);
+}
+
+/**
+ * @brief Turns the snake to a requested direction if CanTurn allows it.
+ */
+bool GameRules::Turn(Snake &snake, Snake::Direction direction) {
+  if (!CanTurn(snake, direction)) {
+    return false;
+  }
+  snake.direction = direction;
+  return true;
+}
+
+/**
+ * @brief Forgets any state the food distributions carry.
+ */
+void GameRules::Reset() {
+  random_w.reset();
+  random_h.reset();
+}
+
+/**
+ * @brief Places food at a random location on the grid that is not occupied by the snake.
+ *
+ * Each random draw scans the body, so on a grid the snake mostly covers, drawing until a free cell comes
+ * up would cost many body scans. From half coverage on, the body is mapped once and the n-th free cell is
+ * taken instead, for a random n; that is linear in the body length plus the grid size.
+ */
+void GameRules::PlaceFood(const Snake &snake, std::mt19937 &engine, SDL_Point &food) {
+  const std::size_t cells = static_cast<std::size_t>(grid_width) * grid_height;
+  if (snake.body.size() * 2 >= cells) {
+    occupied.assign(cells, false);
+    std::size_t free_cells = cells;
+    for (const SDL_Point &cell : snake.body) {
+      std::vector<bool>::reference taken = occupied[static_cast<std::size_t>(cell.y) * grid_width + cell.x];
+      if (!taken) {
+        taken = true;
+        free_cells--;
+      }
+    }
+    if (free_cells == 0) {
+      return;
+    }
+    std::size_t skip = std::uniform_int_distribution<std::size_t>(0, free_cells - 1)(engine);
+    for (std::size_t i = 0; i < cells; ++i) {
+      if (!occupied[i] && skip-- == 0) {
+        food.x = static_cast<int>(i % grid_width);
+        food.y = static_cast<int>(i / grid_width);
+        return;
+      }
+    }
+  }
+
+  int x, y;
+  do {
+    x = random_w(engine);
+    y = random_h(engine);
+  } while (snake.SnakeCell(x, y));
+
+  food.x = x;
+  food.y = y;
+}
+
+/**
+ * @brief Advances the snake by one step and applies eating and steering.
+ *
+ * The snake eats when its head is on the food after the move: the score goes up, new food is placed,
+ * and the snake grows and speeds up. The AutoPilot steers right after the head entered a cell, so the
+ * turn applies to the whole next cell.
+ */
+GameRules::StepResult GameRules::Step(Snake &snake, SDL_Point &food, int &score, std::mt19937 &engine,
+                                      float elapsed_time, AutoPilot *autopilot) {
+  StepResult result;
+  SDL_Point prev_cell{static_cast<int>(snake.head_x), static_cast<int>(snake.head_y)};
+  snake.Update(elapsed_time);
+
+  int new_x = static_cast<int>(snake.head_x);
+  int new_y = static_cast<int>(snake.head_y);
+  result.moved = new_x != prev_cell.x || new_y != prev_cell.y;
+  result.direction = snake.direction;
+
+  if (food.x == new_x && food.y == new_y) {
+    score++;
+    PlaceFood(snake, engine, food);
+    snake.GrowBody();
+    snake.IncreaseSpeed();
+    result.ate = true;
+  }
+  if (autopilot && result.moved) {
+    snake.direction = autopilot->Choose(snake, food);
+  }
+  return result;
+}
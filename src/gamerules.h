@@ -0,0 +1,102 @@
+#ifndef GAME_RULES_H
+#define GAME_RULES_H
+
+#include <random>
+#include <vector>
+#include "SDL.h"
+#include "autopilot.h"
+#include "snake.h"
+
+/**
+ * @brief The rules of one simulation step: moving, eating, growing and steering, and where food appears.
+ *
+ * The snake thread and the headless simulator both advance their games through this class, so the
+ * headless engines verify exactly the rules the game plays by. What happens around a step, such as
+ * sound effects, metrics or restarting after a death, stays with the caller.
+ */
+class GameRules {
+public:
+  /**
+   * @brief What happened during a step.
+   */
+  struct StepResult {
+    bool moved{false}; ///< The head entered a new cell.
+    bool ate{false};   ///< The head reached the food; new food was placed and the snake grows.
+    Snake::Direction direction{}; ///< Direction the snake moved in, before the AutoPilot steered.
+  };
+
+  /**
+   * @brief Returns the direction that reverses the given one.
+   */
+  static Snake::Direction Opposite(Snake::Direction direction);
+
+  /**
+   * @brief Returns true if the snake may turn to a new direction.
+   *
+   * A turn must change the direction, and may only reverse it while the snake is a lone head.
+   *
+   * @param snake Snake to turn.
+   * @param direction Requested direction.
+   */
+  static bool CanTurn(const Snake &snake, Snake::Direction direction);
+
+  /**
+   * @brief Turns the snake to a requested direction if CanTurn allows it.
+   *
+   * Used for key presses, scripted inputs and the AutoPilot alike.
+   *
+   * @param snake Snake to turn.
+   * @param direction Requested direction.
+   * @return true if the direction was changed.
+   */
+  static bool Turn(Snake &snake, Snake::Direction direction);
+
+  /**
+   * @brief Construct a new GameRules object.
+   *
+   * @param grid_width Width of the game grid.
+   * @param grid_height Height of the game grid.
+   */
+  GameRules(int grid_width, int grid_height);
+
+  /**
+   * @brief Forgets any state the food distributions carry, so a reseeded engine repeats its placements.
+   */
+  void Reset();
+
+  /**
+   * @brief Places food on a random cell that is not covered by the snake's body.
+   *
+   * While the snake covers less than half of the grid, random cells are drawn until a free one comes up.
+   * On a fuller grid that could take very many draws, so a free cell is picked at random from a map of
+   * the body instead. If no cell is free, the food stays where it is.
+   *
+   * @param snake Snake whose cells are avoided.
+   * @param engine Food RNG.
+   * @param food Food position to overwrite.
+   */
+  void PlaceFood(const Snake &snake, std::mt19937 &engine, SDL_Point &food);
+
+  /**
+   * @brief Advances the snake by one step and applies eating and steering.
+   *
+   * @param snake Snake to advance.
+   * @param food Food position, replaced when the snake eats.
+   * @param score Score, incremented when the snake eats.
+   * @param engine Food RNG.
+   * @param elapsed_time Simulated time of the step in seconds.
+   * @param autopilot AutoPilot that steers after every cell move, or nullptr.
+   * @return StepResult What happened during the step.
+   */
+  StepResult Step(Snake &snake, SDL_Point &food, int &score, std::mt19937 &engine, float elapsed_time,
+                  AutoPilot *autopilot);
+
+private:
+  const int grid_width;  ///< Width of the game grid.
+  const int grid_height; ///< Height of the game grid.
+  std::uniform_int_distribution<int> random_w; ///< Distribution for randomizing food's horizontal position.
+  std::uniform_int_distribution<int> random_h; ///< Distribution for randomizing food's vertical position.
+  std::vector<bool> occupied; ///< Cells covered by the body, reused by food placement on a full grid.
+};
+
+#endif // GAME_RULES_H
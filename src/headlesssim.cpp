@@ -0,0 +1,283 @@
+#include "headlesssim.h"
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <queue>
+
+namespace {
+
+/**
+ * @brief Kinds of events the event-driven engine schedules. At equal steps, inputs sort first.
+ */
+enum class EventType { kInput, kCellChange, kFoodUnderHead };
+
+/**
+ * @brief A pending event: the step at which something happens that a skipped step would not notice.
+ */
+struct Event {
+  std::uint64_t step;       ///< Step at which the event happens, counted from 1.
+  EventType type;           ///< What happens.
+  std::uint64_t sequence;   ///< Input index, or the state generation the event was computed for.
+
+  bool operator>(const Event &other) const {
+    if (step != other.step) return step > other.step;
+    if (type != other.type) return type > other.type;
+    return sequence > other.sequence;
+  }
+};
+
+/**
+ * @brief Mixes a value into an FNV-1a hash.
+ */
+void Mix(std::uint64_t &hash, int value) {
+  hash ^= static_cast<std::uint32_t>(value);
+  hash *= 1099511628211ull;
+}
+
+} // namespace
+
+/**
+ * @brief Returns true if both runs ended in exactly the same game state.
+ */
+bool HeadlessResult::SameState(const HeadlessResult &other) const {
+  return steps == other.steps && cell_moves == other.cell_moves && games == other.games && score == other.score &&
+         total_score == other.total_score && size == other.size && head_x == other.head_x &&
+         head_y == other.head_y && digest == other.digest;
+}
+
+/**
+ * @brief Construct a new HeadlessSim.
+ *
+ * @param grid_width Width of the game grid.
+ * @param grid_height Height of the game grid.
+ * @param seed Seed of the food placement.
+ * @param inputs Scripted direction changes, sorted by step.
+ * @param autopilot Whether the AutoPilot steers after every cell move.
+ */
+HeadlessSim::HeadlessSim(int grid_width, int grid_height, std::uint32_t seed, std::vector<ScriptedInput> inputs,
+                         bool autopilot)
+    : snake(grid_width, grid_height),
+      rules(grid_width, grid_height),
+      seed(seed),
+      inputs(std::move(inputs)),
+      use_autopilot(autopilot) {}
+
+/**
+ * @brief Resets the game for a new run: reseeds, restores the snake and places the first food.
+ */
+void HeadlessSim::Start() {
+  engine.seed(seed);
+  rules.Reset();
+  games = 1;
+  total_score = 0;
+  cell_moves = 0;
+  if (start_board) {
+    snake.Adopt(start_board->head_x, start_board->head_y, start_board->direction, start_board->speed,
+                start_board->growing, start_board->body.data(), start_board->body.size());
+    food = start_board->food;
+    score = start_board->score;
+    return;
+  }
+  snake.Reset();
+  score = 0;
+  rules.PlaceFood(snake, engine, food);
+}
+
+/**
+ * @brief Starts every run from a board instead of a fresh game.
+ *
+ * @param state Validated board on the simulator's grid; must outlive the runs.
+ */
+void HeadlessSim::StartFrom(const BoardState &state) {
+  start_board = &state;
+}
+
+/**
+ * @brief Applies a scripted key press with the rule the controller uses, GameRules::Turn.
+ */
+void HeadlessSim::ApplyInput(Snake::Direction input) {
+  GameRules::Turn(snake, input);
+}
+
+/**
+ * @brief Executes one step with the game's rules, restarting the game if the snake died.
+ *
+ * @return true if the head entered a new cell.
+ */
+bool HeadlessSim::ExecuteStep() {
+  GameRules::StepResult result = rules.Step(snake, food, score, engine, kStep, use_autopilot ? &autopilot : nullptr);
+  if (result.moved) {
+    cell_moves++;
+  }
+  if (result.ate) {
+    total_score++;
+  }
+
+  if (!snake.alive) {
+    games++;
+    snake.Reset();
+    score = 0;
+    rules.PlaceFood(snake, engine, food);
+  }
+  return result.moved;
+}
+
+/**
+ * @brief Collects the final state of a run.
+ */
+HeadlessResult HeadlessSim::Finish(std::uint64_t steps, std::uint64_t work) const {
+  HeadlessResult result;
+  result.steps = steps;
+  result.work = work;
+  result.cell_moves = cell_moves;
+  result.games = games;
+  result.score = score;
+  result.total_score = total_score;
+  result.size = snake.size;
+  result.head_x = snake.head_x;
+  result.head_y = snake.head_y;
+  std::uint64_t digest = 14695981039346656037ull;
+  for (const SDL_Point &point : snake.body) {
+    Mix(digest, point.x);
+    Mix(digest, point.y);
+  }
+  Mix(digest, food.x);
+  Mix(digest, food.y);
+  result.digest = digest;
+  return result;
+}
+
+/**
+ * @brief Simulates the given number of steps, executing every one of them.
+ *
+ * @param steps Number of steps to simulate.
+ * @return HeadlessResult Final state and cost of the run.
+ */
+HeadlessResult HeadlessSim::RunFixedStep(std::uint64_t steps) {
+  auto start = std::chrono::steady_clock::now();
+  Start();
+  std::size_t next_input = 0;
+  for (std::uint64_t step = 1; step <= steps; ++step) {
+    while (next_input < inputs.size() && inputs[next_input].step == step) {
+      ApplyInput(inputs[next_input++].direction);
+    }
+    ExecuteStep();
+  }
+  HeadlessResult result = Finish(steps, steps);
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+/**
+ * @brief Simulates the given number of steps, jumping from event to event.
+ *
+ * Only steps at which an event is due are executed. Every state change bumps a generation counter, and
+ * cell-change and food events computed for an older generation are discarded when they surface. The
+ * steps in between change nothing but the head's position within its cell, which Snake::Advance applies
+ * in one go.
+ *
+ * @param steps Number of steps to simulate.
+ * @return HeadlessResult Final state and cost of the run.
+ */
+HeadlessResult HeadlessSim::RunEventDriven(std::uint64_t steps) {
+  auto start = std::chrono::steady_clock::now();
+  Start();
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+  for (std::size_t i = 0; i < inputs.size() && inputs[i].step <= steps; ++i) {
+    events.push(Event{inputs[i].step, EventType::kInput, i});
+  }
+
+  std::uint64_t now = 0;
+  std::uint64_t generation = 0;
+  std::uint64_t work = 0;
+  auto schedule = [&]() {
+    generation++;
+    std::uint64_t until_move = snake.StepsUntilCellChange(kStep);
+    if (until_move <= steps - now) {
+      events.push(Event{now + until_move, EventType::kCellChange, generation});
+    }
+    if (now < steps && food.x == static_cast<int>(snake.head_x) && food.y == static_cast<int>(snake.head_y)) {
+      events.push(Event{now + 1, EventType::kFoodUnderHead, generation});
+    }
+  };
+  schedule();
+
+  while (!events.empty()) {
+    const Event event = events.top();
+    if (event.type != EventType::kInput && event.sequence != generation) {
+      events.pop();
+      continue;
+    }
+
+    snake.Advance(event.step - now - 1, kStep);
+    while (!events.empty() && events.top().step == event.step) {
+      if (events.top().type == EventType::kInput) {
+        ApplyInput(inputs[events.top().sequence].direction);
+      }
+      events.pop();
+    }
+    ExecuteStep();
+    now = event.step;
+    work++;
+    schedule();
+  }
+  snake.Advance(steps - now, kStep);
+
+  HeadlessResult result = Finish(steps, work);
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+/**
+ * @brief Generates a random input script with a turn every 20 to 400 steps.
+ *
+ * @param seed Seed of the script.
+ * @param steps Length of the run the script covers.
+ * @return std::vector<ScriptedInput> Inputs sorted by step.
+ */
+std::vector<ScriptedInput> HeadlessSim::RandomScript(std::uint32_t seed, std::uint64_t steps) {
+  static constexpr Snake::Direction kDirections[] = {Snake::Direction::kUp, Snake::Direction::kDown,
+                                                     Snake::Direction::kLeft, Snake::Direction::kRight};
+  std::mt19937 engine(seed ^ 0x9e3779b9u);
+  std::uniform_int_distribution<int> gap(20, 400);
+  std::uniform_int_distribution<int> direction(0, 3);
+  std::vector<ScriptedInput> script;
+  for (std::uint64_t step = gap(engine); step <= steps; step += gap(engine)) {
+    script.push_back(ScriptedInput{step, kDirections[direction(engine)]});
+  }
+  return script;
+}
+
+/**
+ * @brief Runs both engines on the same seed and script, prints their cost and whether they agree.
+ *
+ * @param grid_width Width of the game grid.
+ * @param grid_height Height of the game grid.
+ * @param seed Seed of the food placement and the input script.
+ * @param steps Number of steps to simulate.
+ * @param board Board to start from, or nullptr for a fresh game.
+ * @param out Stream to print the comparison to.
+ * @return true if both engines ended in the same state.
+ */
+bool VerifyHeadless(int grid_width, int grid_height, std::uint32_t seed, std::uint64_t steps, const BoardState *board,
+                    std::ostream &out) {
+  HeadlessSim sim(grid_width, grid_height, seed, HeadlessSim::RandomScript(seed, steps), true);
+  if (board) {
+    sim.StartFrom(*board);
+  }
+  HeadlessResult fixed = sim.RunFixedStep(steps);
+  HeadlessResult events = sim.RunEventDriven(steps);
+
+  out << std::fixed << std::setprecision(1) << "Headless run, seed " << seed << ", " << steps << " steps ("
+      << steps / 100.0 << " s simulated): " << fixed.games << " games, " << fixed.total_score << " food, "
+      << fixed.cell_moves << " cell moves\n";
+  out << std::setprecision(2) << "  fixed step:   " << fixed.work << " steps executed in " << fixed.seconds * 1000.0
+      << " ms\n";
+  out << "  event driven: " << events.work << " steps executed in " << events.seconds * 1000.0 << " ms ("
+      << (events.cell_moves > 0 ? static_cast<double>(events.work) / events.cell_moves : 0.0)
+      << " per cell move)\n";
+
+  bool same = fixed.SameState(events);
+  out << (same ? "  final states match\n" : "  final states DIFFER\n");
+  return same;
+}
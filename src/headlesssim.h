@@ -0,0 +1,140 @@
+#ifndef HEADLESS_SIM_H
+#define HEADLESS_SIM_H
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <vector>
+#include "SDL.h"
+#include "autopilot.h"
+#include "boardstate.h"
+#include "gamerules.h"
+#include "snake.h"
+
+/**
+ * @brief A direction change scheduled for a given simulation step.
+ */
+struct ScriptedInput {
+  std::uint64_t step;         ///< Step before which the input is applied, counted from 1.
+  Snake::Direction direction; ///< Requested direction.
+};
+
+/**
+ * @brief Outcome of a headless run, compared between the two engines.
+ */
+struct HeadlessResult {
+  std::uint64_t steps{0};     ///< Simulation steps covered.
+  std::uint64_t work{0};      ///< Steps actually executed one by one.
+  std::uint64_t cell_moves{0}; ///< Times the head entered a new cell.
+  int games{1};               ///< Games played, including the current one.
+  int score{0};               ///< Score of the current game.
+  int total_score{0};         ///< Food eaten over all games.
+  int size{1};                ///< Size of the snake in the current game.
+  float head_x{0.0f};         ///< Final head position.
+  float head_y{0.0f};
+  std::uint64_t digest{0};    ///< Hash of the final body, food and head cells.
+  double seconds{0.0};        ///< Wall time the run took.
+
+  /**
+   * @brief Returns true if both runs ended in exactly the same game state.
+   */
+  bool SameState(const HeadlessResult &other) const;
+};
+
+/**
+ * @brief Runs the game without a display on a fixed simulation step, using either of two engines.
+ *
+ * The reference engine executes every step, as the snake thread does when fast-forwarding. The
+ * event-driven engine keeps pending events in a min-heap ordered by step: the next scripted input,
+ * the next cell the head enters, and food placed under the head. It skips straight to the earliest
+ * one with Snake::Advance, so the work done is proportional to the number of events rather than the
+ * number of steps. Both engines execute steps through GameRules, the rules the game itself plays by,
+ * and since the snake's movement is exact, they end in the same state.
+ *
+ * Games that end are restarted immediately, as in soak mode.
+ */
+class HeadlessSim {
+public:
+  /**
+   * @brief Construct a new HeadlessSim.
+   *
+   * @param grid_width Width of the game grid.
+   * @param grid_height Height of the game grid.
+   * @param seed Seed of the food placement.
+   * @param inputs Scripted direction changes, sorted by step.
+   * @param autopilot Whether the AutoPilot steers after every cell move.
+   */
+  HeadlessSim(int grid_width, int grid_height, std::uint32_t seed, std::vector<ScriptedInput> inputs,
+              bool autopilot);
+
+  /**
+   * @brief Starts every run from a board instead of a fresh game. Later games still start fresh.
+   *
+   * @param state Validated board on the simulator's grid.
+   */
+  void StartFrom(const BoardState &state);
+
+  /**
+   * @brief Simulates the given number of steps, executing every one of them.
+   *
+   * @param steps Number of steps to simulate.
+   * @return HeadlessResult Final state and cost of the run.
+   */
+  HeadlessResult RunFixedStep(std::uint64_t steps);
+
+  /**
+   * @brief Simulates the given number of steps, jumping from event to event.
+   *
+   * @param steps Number of steps to simulate.
+   * @return HeadlessResult Final state and cost of the run.
+   */
+  HeadlessResult RunEventDriven(std::uint64_t steps);
+
+  /**
+   * @brief Generates a random input script with a turn every few hundred steps.
+   *
+   * @param seed Seed of the script.
+   * @param steps Length of the run the script covers.
+   * @return std::vector<ScriptedInput> Inputs sorted by step.
+   */
+  static std::vector<ScriptedInput> RandomScript(std::uint32_t seed, std::uint64_t steps);
+
+private:
+  static constexpr float kStep = 0.01f; ///< Simulated seconds per step, the snake thread's tick interval.
+
+  void Start();
+  void ApplyInput(Snake::Direction input);
+  bool ExecuteStep();
+  HeadlessResult Finish(std::uint64_t steps, std::uint64_t work) const;
+
+  Snake snake;
+  SDL_Point food{0, 0};
+  std::mt19937 engine;
+  GameRules rules;
+  const std::uint32_t seed;
+  const std::vector<ScriptedInput> inputs;
+  const bool use_autopilot;
+  const BoardState *start_board{nullptr};
+  AutoPilot autopilot;
+
+  int games{1};
+  int score{0};
+  int total_score{0};
+  std::uint64_t cell_moves{0};
+};
+
+/**
+ * @brief Runs both engines on the same seed and script, prints their cost and whether they agree.
+ *
+ * @param grid_width Width of the game grid.
+ * @param grid_height Height of the game grid.
+ * @param seed Seed of the food placement and the input script.
+ * @param steps Number of steps to simulate.
+ * @param board Board to start from, or nullptr for a fresh game.
+ * @param out Stream to print the comparison to.
+ * @return true if both engines ended in the same state.
+ */
+bool VerifyHeadless(int grid_width, int grid_height, std::uint32_t seed, std::uint64_t steps, const BoardState *board,
+                    std::ostream &out);
+
+#endif // HEADLESS_SIM_H
@@ -0,0 +1,120 @@
+#include "histogram.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Returns the bucket index a value is counted in.
+ *
+ * Small values map to themselves. Larger values are indexed by their power of two and the
+ * kSubBucketBits bits following the leading one.
+ *
+ * @param value Value to classify.
+ * @return int Bucket index in [0, kBuckets).
+ */
+int Histogram::BucketIndex(std::uint64_t value) {
+  if (value < kSubBuckets) {
+    return static_cast<int>(value);
+  }
+#if defined(__GNUC__) || defined(__clang__)
+  int width = 64 - __builtin_clzll(value);
+#else
+  int width = 0;
+  for (std::uint64_t v = value; v != 0; v >>= 1) {
+    ++width;
+  }
+#endif
+  int shift = width - 1 - kSubBucketBits;
+  int sub_bucket = static_cast<int>((value >> shift) & (kSubBuckets - 1));
+  return std::min(kSubBuckets * (shift + 1) + sub_bucket, kBuckets - 1);
+}
+
+/**
+ * @brief Returns the largest value counted in a bucket.
+ *
+ * @param index Bucket index in [0, kBuckets).
+ * @return std::uint64_t Inclusive upper bound of the bucket.
+ */
+std::uint64_t Histogram::BucketUpperBound(int index) {
+  if (index < kSubBuckets) {
+    return static_cast<std::uint64_t>(index);
+  }
+  int shift = index / kSubBuckets - 1;
+  std::uint64_t lower = static_cast<std::uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+  return lower + (std::uint64_t{1} << shift) - 1;
+}
+
+/**
+ * @brief Records one value using relaxed atomics only.
+ *
+ * @param value Value to record.
+ */
+void Histogram::Record(std::uint64_t value) {
+  buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  count.fetch_add(1, std::memory_order_relaxed);
+  sum.fetch_add(value, std::memory_order_relaxed);
+
+  std::uint64_t current = max.load(std::memory_order_relaxed);
+  while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+/**
+ * @brief Copies the current bucket counts.
+ *
+ * Writers are not stopped, so the copy may be off by the few values recorded while it was taken.
+ */
+Histogram::Snapshot Histogram::Read() const {
+  Snapshot snapshot;
+  for (int i = 0; i < kBuckets; ++i) {
+    snapshot.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+  }
+  snapshot.count = count.load(std::memory_order_relaxed);
+  snapshot.sum = sum.load(std::memory_order_relaxed);
+  snapshot.max = max.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+/**
+ * @brief Estimates a percentile as the upper bound of the bucket holding it, capped at max.
+ */
+std::uint64_t Histogram::Snapshot::Percentile(double percentile) const {
+  std::uint64_t total = 0;
+  for (std::uint64_t bucket : buckets) {
+    total += bucket;
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(total * std::clamp(percentile, 0.0, 100.0) / 100.0));
+  rank = std::max<std::uint64_t>(rank, 1);
+  std::uint64_t seen = 0;
+  for (int i = 0; i < kBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return std::min(BucketUpperBound(i), max);
+    }
+  }
+  return max;
+}
+
+/**
+ * @brief Returns the mean of the recorded values, or 0 if nothing was recorded.
+ */
+double Histogram::Snapshot::Mean() const {
+  return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+}
+
+/**
+ * @brief Returns the values recorded between an earlier snapshot and this one.
+ */
+Histogram::Snapshot Histogram::Snapshot::Since(const Snapshot &earlier) const {
+  Snapshot delta;
+  for (int i = 0; i < kBuckets; ++i) {
+    delta.buckets[i] = buckets[i] - std::min(buckets[i], earlier.buckets[i]);
+  }
+  delta.count = count - std::min(count, earlier.count);
+  delta.sum = sum - std::min(sum, earlier.sum);
+  delta.max = max;
+  return delta;
+}
@@ -0,0 +1,83 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Lock-free histogram with log-linear buckets.
+ *
+ * Values below kSubBuckets get a bucket each; every power-of-two range above that is split into
+ * kSubBuckets equal buckets, so a bucket bound is never more than 25% away from the values it counts.
+ * Recording is a handful of relaxed atomic operations, so it can be called from any thread on a hot
+ * path. The unit of the recorded values is chosen by the caller.
+ */
+class Histogram {
+public:
+  static constexpr int kSubBucketBits = 2;                  ///< log2 of the buckets per power of two.
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;   ///< Buckets per power of two.
+  static constexpr int kBuckets = kSubBuckets * 44;         ///< Enough buckets for values up to 2^45.
+
+  /**
+   * @brief A consistent-enough copy of the histogram taken at one point in time.
+   */
+  struct Snapshot {
+    std::array<std::uint64_t, kBuckets> buckets{}; ///< Count per bucket.
+    std::uint64_t count{0};                        ///< Total number of recorded values.
+    std::uint64_t sum{0};                          ///< Sum of all recorded values.
+    std::uint64_t max{0};                          ///< Largest recorded value.
+
+    /**
+     * @brief Estimates a percentile as the upper bound of the bucket holding it, capped at max.
+     *
+     * @param percentile Percentile in the range [0, 100].
+     * @return std::uint64_t Estimated value, or 0 if nothing was recorded.
+     */
+    std::uint64_t Percentile(double percentile) const;
+
+    /**
+     * @brief Returns the mean of the recorded values, or 0 if nothing was recorded.
+     */
+    double Mean() const;
+
+    /**
+     * @brief Returns the values recorded between an earlier snapshot and this one.
+     *
+     * The max of the result is the max of this snapshot, since maxima cannot be subtracted.
+     *
+     * @param earlier Snapshot taken before this one from the same histogram.
+     */
+    Snapshot Since(const Snapshot &earlier) const;
+  };
+
+  /**
+   * @brief Records one value.
+   *
+   * @param value Value to record.
+   */
+  void Record(std::uint64_t value);
+
+  /**
+   * @brief Copies the current bucket counts.
+   */
+  Snapshot Read() const;
+
+  /**
+   * @brief Returns the bucket index a value is counted in.
+   */
+  static int BucketIndex(std::uint64_t value);
+
+  /**
+   * @brief Returns the largest value counted in a bucket.
+   */
+  static std::uint64_t BucketUpperBound(int index);
+
+private:
+  std::array<std::atomic<std::uint64_t>, kBuckets> buckets{}; ///< Count per bucket.
+  std::atomic<std::uint64_t> count{0};                        ///< Total number of recorded values.
+  std::atomic<std::uint64_t> sum{0};                          ///< Sum of all recorded values.
+  std::atomic<std::uint64_t> max{0};                          ///< Largest recorded value.
+};
+
+#endif // HISTOGRAM_H
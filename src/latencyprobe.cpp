@@ -0,0 +1,167 @@
+#include "latencyprobe.h"
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+
+/**
+ * @brief Returns the milliseconds elapsed between two steady clock time points.
+ */
+double ElapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+  return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+/**
+ * @brief Returns an exact percentile of a sample set, or 0 if it is empty.
+ */
+double Percentile(std::vector<double> samples, double percentile) {
+  if (samples.empty()) {
+    return 0.0;
+  }
+  std::size_t rank = static_cast<std::size_t>(percentile / 100.0 * (samples.size() - 1) + 0.5);
+  std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+  return samples[rank];
+}
+
+/**
+ * @brief Prints one line of the latency table.
+ */
+void PrintStage(std::ostream &out, const char *stage, const std::vector<double> &samples) {
+  out << std::left << std::setw(18) << stage << std::right << std::setw(8) << samples.size()
+      << std::setw(10) << Percentile(samples, 50) << std::setw(10) << Percentile(samples, 90)
+      << std::setw(10) << Percentile(samples, 99) << std::setw(10) << Percentile(samples, 100) << "\n";
+}
+
+/**
+ * @brief Key presses cycled through by the injector; each one is a legal turn from the previous one.
+ */
+constexpr SDL_Keycode kInjectedKeys[] = {SDLK_LEFT, SDLK_UP, SDLK_RIGHT, SDLK_UP};
+
+} // namespace
+
+/**
+ * @brief Construct a new LatencyProbe.
+ *
+ * @param injected_keys Number of synthetic key presses to inject; 0 measures real input only.
+ */
+LatencyProbe::LatencyProbe(int injected_keys)
+    : injected_keys(injected_keys),
+      next_injection(Clock::now() + kInjectionInterval) {}
+
+/**
+ * @brief Starts tracking a key press that changed the snake's direction.
+ *
+ * The SDL timestamp has millisecond resolution and its own epoch, so the event time is reconstructed
+ * from how long ago the event was queued. A press still in flight is dropped in favour of the new one.
+ */
+void LatencyProbe::OnInput(Uint32 event_timestamp, Snake::Direction direction) {
+  Clock::time_point now = Clock::now();
+  Uint32 queued_ms = SDL_GetTicks() - event_timestamp;
+
+  std::lock_guard<std::mutex> lock(mtx);
+  if (stage != Stage::kIdle) {
+    dropped++;
+  }
+  stage = Stage::kWaitingSim;
+  pending_direction = direction;
+  handled_time = now;
+  event_time = now - std::chrono::milliseconds(queued_ms);
+}
+
+/**
+ * @brief Marks the tracked press as applied once the head has moved a cell in the new direction.
+ */
+void LatencyProbe::OnSimMove(Snake::Direction direction) {
+  std::lock_guard<std::mutex> lock(mtx);
+  sim_moves++;
+  if (stage == Stage::kWaitingSim && direction == pending_direction) {
+    sim_time = Clock::now();
+    applied_move = sim_moves;
+    stage = Stage::kWaitingPresent;
+  }
+}
+
+/**
+ * @brief Remembers how far the simulation had moved when the frame started drawing.
+ *
+ * The frame may be drawn while the simulation keeps running, so only moves made before this point are
+ * guaranteed to be on screen once it is presented.
+ */
+void LatencyProbe::OnFrameStart() {
+  std::lock_guard<std::mutex> lock(mtx);
+  frame_moves = sim_moves;
+}
+
+/**
+ * @brief Completes the tracked press with the first frame presented that started after the simulation applied it.
+ *
+ * Also drops a press that has not reached the screen within kTimeout, e.g. because the game ended.
+ */
+void LatencyProbe::OnFramePresented() {
+  Clock::time_point now = Clock::now();
+  std::lock_guard<std::mutex> lock(mtx);
+  if (stage == Stage::kWaitingPresent && applied_move <= frame_moves) {
+    Complete(now);
+  } else if (stage == Stage::kWaitingSim && now - handled_time > kTimeout) {
+    dropped++;
+    stage = Stage::kIdle;
+  }
+}
+
+/**
+ * @brief Records the samples of the tracked press. Expects mtx to be held.
+ */
+void LatencyProbe::Complete(Clock::time_point presented) {
+  handled_ms.push_back(ElapsedMs(event_time, handled_time));
+  sim_ms.push_back(ElapsedMs(event_time, sim_time));
+  present_ms.push_back(ElapsedMs(event_time, presented));
+  stage = Stage::kIdle;
+}
+
+/**
+ * @brief Pushes the next synthetic key press once the previous one has been measured.
+ *
+ * Presses are spaced by kInjectionInterval so that they land at varying phases of the simulation tick.
+ */
+void LatencyProbe::InjectDue() {
+  Clock::time_point now = Clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (injected >= injected_keys || stage != Stage::kIdle || now < next_injection) {
+      return;
+    }
+    injected++;
+    next_injection = now + kInjectionInterval;
+  }
+
+  SDL_Event event{};
+  event.type = SDL_KEYDOWN;
+  event.key.state = SDL_PRESSED;
+  event.key.keysym.sym = kInjectedKeys[(injected - 1) % SDL_arraysize(kInjectedKeys)];
+  SDL_PushEvent(&event);
+}
+
+/**
+ * @brief Returns true once every injected key press has been measured or dropped.
+ */
+bool LatencyProbe::Finished() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  return injected_keys > 0 && injected >= injected_keys && stage == Stage::kIdle;
+}
+
+/**
+ * @brief Prints the latency distribution of each stage, in milliseconds.
+ */
+void LatencyProbe::Report(std::ostream &out) const {
+  std::lock_guard<std::mutex> lock(mtx);
+  out << "Input latency (ms from key event):\n";
+  out << std::left << std::setw(18) << "stage" << std::right << std::setw(8) << "count"
+      << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+  out << std::fixed << std::setprecision(2);
+  PrintStage(out, "handled", handled_ms);
+  PrintStage(out, "applied in sim", sim_ms);
+  PrintStage(out, "presented", present_ms);
+  if (dropped > 0) {
+    out << dropped << " key presses dropped before reaching the screen\n";
+  }
+}
@@ -0,0 +1,109 @@
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include "SDL.h"
+#include "snake.h"
+
+/**
+ * @brief Measures input-to-photon latency of direction changes.
+ *
+ * One key press is tracked at a time through three stages: the event is handled by the controller,
+ * the simulation moves the head one cell in the new direction, and the first frame that started drawing
+ * after that move is presented. Latencies are measured from the SDL event timestamp, so time the event spent in
+ * the SDL queue is included.
+ *
+ * The probe can also inject synthetic key presses through SDL_PushEvent, so the measurement can run
+ * without a player (e.g. in CI with SDL_VIDEODRIVER=dummy).
+ */
+class LatencyProbe {
+public:
+  /**
+   * @brief Construct a new LatencyProbe.
+   *
+   * @param injected_keys Number of synthetic key presses to inject; 0 measures real input only.
+   */
+  explicit LatencyProbe(int injected_keys);
+
+  /**
+   * @brief Called by the controller when a key press changed the snake's direction.
+   *
+   * @param event_timestamp SDL timestamp of the key event, in milliseconds.
+   * @param direction Direction the snake was turned to.
+   */
+  void OnInput(Uint32 event_timestamp, Snake::Direction direction);
+
+  /**
+   * @brief Called by the simulation thread whenever the snake's head enters a new cell.
+   *
+   * @param direction Direction the head moved in.
+   */
+  void OnSimMove(Snake::Direction direction);
+
+  /**
+   * @brief Called by the main loop right before it starts drawing a frame.
+   */
+  void OnFrameStart();
+
+  /**
+   * @brief Called by the main loop right after a frame has been presented.
+   */
+  void OnFramePresented();
+
+  /**
+   * @brief Pushes the next synthetic key press once the previous one has been measured.
+   *
+   * Does nothing when no keys are to be injected.
+   */
+  void InjectDue();
+
+  /**
+   * @brief Returns true once every injected key press has been measured or dropped.
+   */
+  bool Finished() const;
+
+  /**
+   * @brief Prints the latency distribution of each stage.
+   *
+   * @param out Stream to print to.
+   */
+  void Report(std::ostream &out) const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Progress of the key press currently being tracked.
+   */
+  enum class Stage { kIdle, kWaitingSim, kWaitingPresent };
+
+  static constexpr std::chrono::milliseconds kInjectionInterval{200}; ///< Gap between synthetic key presses.
+  static constexpr std::chrono::seconds kTimeout{1};                   ///< Presses not seen on screen by then are dropped.
+
+  void Complete(Clock::time_point presented);
+
+  mutable std::mutex mtx;                 ///< Guards all members below; the probe is used from two threads.
+  Stage stage{Stage::kIdle};              ///< Stage of the tracked key press.
+  Snake::Direction pending_direction{};   ///< Direction the tracked key press turned the snake to.
+  Clock::time_point event_time;           ///< SDL event time, translated to the steady clock.
+  Clock::time_point handled_time;         ///< Time the controller handled the event.
+  Clock::time_point sim_time;             ///< Time the simulation moved in the new direction.
+  std::uint64_t sim_moves{0};             ///< Cells the head has entered so far.
+  std::uint64_t applied_move{0};          ///< Value of sim_moves once the tracked press was applied.
+  std::uint64_t frame_moves{0};           ///< Value of sim_moves when the current frame started drawing.
+
+  std::vector<double> handled_ms;         ///< Event-to-handled latency samples.
+  std::vector<double> sim_ms;             ///< Event-to-simulation latency samples.
+  std::vector<double> present_ms;         ///< Event-to-present latency samples.
+  int dropped{0};                         ///< Key presses that timed out or were superseded.
+
+  const int injected_keys;                ///< Total number of synthetic key presses to inject.
+  int injected{0};                        ///< Synthetic key presses injected so far.
+  Clock::time_point next_injection;       ///< Earliest time for the next synthetic key press.
+};
+
+#endif // LATENCY_PROBE_H
@@ -0,0 +1,111 @@
+#include "lockprofiler.h"
+
+#ifdef SNAKE_ENABLE_LOCK_PROFILING
+
+#include <cstring>
+#include <iomanip>
+
+namespace {
+
+/**
+ * @brief Returns the nanoseconds elapsed between two time points.
+ */
+std::uint64_t ElapsedNs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+} // namespace
+
+/**
+ * @brief Returns the process-wide profiler, creating it on first use.
+ */
+LockProfiler &LockProfiler::Instance() {
+  static LockProfiler profiler;
+  return profiler;
+}
+
+/**
+ * @brief Returns the statistics for a lock name, creating them on first use.
+ *
+ * Mutexes that share a name (e.g. the snake mutex of successive Snake objects) share statistics.
+ */
+LockStats &LockProfiler::Register(const char *name) {
+  std::lock_guard<std::mutex> lock(registry_mtx);
+  for (auto &entry : stats) {
+    if (std::strcmp(entry->name, name) == 0) {
+      return *entry;
+    }
+  }
+  stats.push_back(std::make_unique<LockStats>(name));
+  return *stats.back();
+}
+
+/**
+ * @brief Prints a table with contention, wait and hold times for every registered lock.
+ *
+ * Times are printed in microseconds; percentiles are bucket upper bounds and therefore within 25%
+ * of the true value.
+ */
+void LockProfiler::Report(std::ostream &out) {
+  std::lock_guard<std::mutex> lock(registry_mtx);
+  out << "Lock profile (times in us):\n";
+  out << std::left << std::setw(22) << "lock" << std::right
+      << std::setw(10) << "acquired" << std::setw(10) << "blocked" << std::setw(8) << "%"
+      << std::setw(10) << "wait p50" << std::setw(10) << "wait p99" << std::setw(10) << "wait max"
+      << std::setw(10) << "hold p50" << std::setw(10) << "hold p99" << std::setw(10) << "hold max" << "\n";
+
+  out << std::fixed << std::setprecision(1);
+  for (const auto &entry : stats) {
+    std::uint64_t acquisitions = entry->acquisitions.load(std::memory_order_relaxed);
+    std::uint64_t contentions = entry->contentions.load(std::memory_order_relaxed);
+    Histogram::Snapshot wait = entry->wait_ns.Read();
+    Histogram::Snapshot hold = entry->hold_ns.Read();
+    out << std::left << std::setw(22) << entry->name << std::right
+        << std::setw(10) << acquisitions << std::setw(10) << contentions
+        << std::setw(8) << (acquisitions ? 100.0 * contentions / acquisitions : 0.0)
+        << std::setw(10) << wait.Percentile(50) / 1000.0 << std::setw(10) << wait.Percentile(99) / 1000.0
+        << std::setw(10) << wait.max / 1000.0
+        << std::setw(10) << hold.Percentile(50) / 1000.0 << std::setw(10) << hold.Percentile(99) / 1000.0
+        << std::setw(10) << hold.max / 1000.0 << "\n";
+  }
+}
+
+/**
+ * @brief Acquires the mutex, counting it as contended and timing the wait if it is already held.
+ */
+void ProfiledMutex::lock() {
+  if (mtx.try_lock()) {
+    acquired = std::chrono::steady_clock::now();
+    stats.wait_ns.Record(0);
+  } else {
+    auto wait_start = std::chrono::steady_clock::now();
+    mtx.lock();
+    acquired = std::chrono::steady_clock::now();
+    stats.contentions.fetch_add(1, std::memory_order_relaxed);
+    stats.wait_ns.Record(ElapsedNs(wait_start, acquired));
+  }
+  stats.acquisitions.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Acquires the mutex if it is free; a failed attempt is not counted as contention.
+ */
+bool ProfiledMutex::try_lock() {
+  if (!mtx.try_lock()) {
+    return false;
+  }
+  acquired = std::chrono::steady_clock::now();
+  stats.wait_ns.Record(0);
+  stats.acquisitions.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+/**
+ * @brief Records the hold time and releases the mutex.
+ */
+void ProfiledMutex::unlock() {
+  stats.hold_ns.Record(ElapsedNs(acquired, std::chrono::steady_clock::now()));
+  mtx.unlock();
+}
+
+#endif // SNAKE_ENABLE_LOCK_PROFILING
@@ -0,0 +1,118 @@
+#ifndef LOCK_PROFILER_H
+#define LOCK_PROFILER_H
+
+/**
+ * @file lockprofiler.h
+ * @brief Mutex wrapper that records wait time, hold time and contention per named lock.
+ *
+ * Profiling is compiled in only when SNAKE_ENABLE_LOCK_PROFILING is defined (CMake option of the same
+ * name). Without it, ProfiledMutex is a std::mutex that only takes the name for source compatibility.
+ *
+ * Code that waits on a ProfiledMutex uses ProfiledConditionVariable and ProfiledUniqueLock, which are
+ * std::condition_variable_any over the wrapper when profiling and plain std::condition_variable over
+ * std::mutex otherwise.
+ */
+
+#include <condition_variable>
+#include <mutex>
+
+#ifdef SNAKE_ENABLE_LOCK_PROFILING
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include "histogram.h"
+
+/**
+ * @brief Statistics shared by every mutex registered under the same name.
+ */
+struct LockStats {
+  explicit LockStats(const char *name) : name(name) {}
+
+  const char *name;                          ///< Name the lock was registered with.
+  std::atomic<std::uint64_t> acquisitions{0}; ///< Number of successful lock() calls.
+  std::atomic<std::uint64_t> contentions{0};  ///< Number of lock() calls that had to block.
+  Histogram wait_ns;                          ///< Time spent blocked in lock(), in nanoseconds.
+  Histogram hold_ns;                          ///< Time between acquisition and unlock(), in nanoseconds.
+};
+
+/**
+ * @brief Registry of lock statistics, reported at shutdown.
+ */
+class LockProfiler {
+public:
+  /**
+   * @brief Returns the process-wide profiler.
+   */
+  static LockProfiler &Instance();
+
+  /**
+   * @brief Returns the statistics for a lock name, creating them on first use.
+   *
+   * @param name Static string naming the lock.
+   */
+  LockStats &Register(const char *name);
+
+  /**
+   * @brief Prints a table with contention, wait and hold times for every registered lock.
+   *
+   * @param out Stream to print to.
+   */
+  void Report(std::ostream &out);
+
+private:
+  std::mutex registry_mtx;                        ///< Guards stats.
+  std::vector<std::unique_ptr<LockStats>> stats;  ///< One entry per lock name.
+};
+
+/**
+ * @brief Mutex that records its wait time, hold time and contention into LockStats.
+ *
+ * Satisfies the Lockable requirements, so it works with std::lock_guard, std::unique_lock and
+ * std::condition_variable_any.
+ */
+class ProfiledMutex {
+public:
+  explicit ProfiledMutex(const char *name) : stats(LockProfiler::Instance().Register(name)) {}
+
+  ProfiledMutex(const ProfiledMutex &) = delete;
+  ProfiledMutex &operator=(const ProfiledMutex &) = delete;
+
+  void lock();
+  bool try_lock();
+  void unlock();
+
+private:
+  std::mutex mtx;                                   ///< Underlying mutex.
+  LockStats &stats;                                 ///< Statistics this mutex reports into.
+  std::chrono::steady_clock::time_point acquired;   ///< Acquisition time, only touched by the owner.
+};
+
+using ProfiledConditionVariable = std::condition_variable_any; ///< Condition variable working with ProfiledMutex.
+using ProfiledUniqueLock = std::unique_lock<ProfiledMutex>;     ///< Lock type ProfiledConditionVariable waits with.
+
+#define LOCK_PROFILE_REPORT(out) LockProfiler::Instance().Report(out)
+
+#else
+
+/**
+ * @brief A std::mutex accepting a lock name, used when lock profiling is compiled out.
+ *
+ * Being a std::mutex, it can be waited on with std::condition_variable at no extra cost.
+ */
+class ProfiledMutex : public std::mutex {
+public:
+  explicit ProfiledMutex(const char *) {}
+};
+
+using ProfiledConditionVariable = std::condition_variable; ///< Condition variable working with ProfiledMutex.
+using ProfiledUniqueLock = std::unique_lock<std::mutex>;   ///< Lock type ProfiledConditionVariable waits with.
+
+#define LOCK_PROFILE_REPORT(out) ((void)0)
+
+#endif // SNAKE_ENABLE_LOCK_PROFILING
+
+#endif // LOCK_PROFILER_H
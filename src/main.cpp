@@ -1,8 +1,14 @@
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <random>
 #include "controller.h"
 #include "game.h"
 #include "renderer.h"
+#include "options.h"
+#include "metricsexporter.h"
+#include "headlesssim.h"
+#include "boardstate.h"
 
 /**
  * @brief Entry point for the Snake game application.
@@ -10,9 +16,13 @@
  * Initializes game components including the renderer, controller, and game logic,
  * then runs the game loop and displays the final score and snake size upon termination.
  * 
+ * @param argc Argument count; see ParseOptions for the supported options.
+ * @param argv Argument vector.
  * @return int Returns 0 to signal normal termination of the program.
  */
-int main() {
+int main(int argc, char *argv[]) {
+  const GameOptions options = ParseOptions(argc, argv);
+
   // Frame rate configuration.
   constexpr std::size_t kFramesPerSecond{60};
   constexpr std::size_t kMsPerFrame{1000 / kFramesPerSecond}; // Milliseconds per frame.
@@ -23,12 +33,87 @@ int main() {
   constexpr std::size_t kGridWidth{32};
   constexpr std::size_t kGridHeight{32};
 
+  // A board given on the command line determines the grid; the window keeps its size, so on grids larger
+  // than the window a cell covers less than a pixel.
+  std::size_t grid_width = kGridWidth;
+  std::size_t grid_height = kGridHeight;
+  BoardState board;
+  if (!options.board.empty()) {
+    auto load_start = std::chrono::steady_clock::now();
+    std::string error;
+    if (!MakeBoard(options.board, board, error)) {
+      std::cerr << "Board " << options.board << " could not be loaded: " << error << "\n";
+      return EXIT_FAILURE;
+    }
+    auto load_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - load_start);
+    std::cout << "Loaded board " << options.board << ": " << board.grid_width << "x" << board.grid_height
+              << " grid, snake size " << board.body.size() + 1 << " in " << load_time.count() << " ms\n";
+    grid_width = board.grid_width;
+    grid_height = board.grid_height;
+  }
+  const std::size_t screen_width = kScreenWidth;
+  const std::size_t screen_height = kScreenHeight;
+
+  // Headless runs compare the simulation engines without opening a window.
+  if (options.headless_steps > 0) {
+    std::uint32_t seed = options.seed > 0 ? static_cast<std::uint32_t>(options.seed) : std::random_device{}();
+    bool same = VerifyHeadless(grid_width, grid_height, seed, options.headless_steps,
+                               options.board.empty() ? nullptr : &board, std::cout);
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  // Soak runs render offscreen unless a video driver was chosen explicitly.
+  if (options.soak_seconds > 0 && !SDL_getenv("SDL_VIDEODRIVER")) {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+  }
+
   // Create renderer and controller objects using smart pointers for automatic resource management.
-  std::unique_ptr<Renderer> renderer = std::make_unique<Renderer>(kScreenWidth, kScreenHeight, kGridWidth, kGridHeight);
+  std::unique_ptr<Renderer> renderer = std::make_unique<Renderer>(screen_width, screen_height, grid_width, grid_height);
   std::unique_ptr<Controller> controller = std::make_unique<Controller>();
+  if (options.render_threads > 0) {
+    renderer->SetRenderThreads(options.render_threads);
+  }
   
   // Initialize the game with grid dimensions.
-  Game game(kGridWidth, kGridHeight);
+  Game game(grid_width, grid_height);
+  if (!options.board.empty()) {
+    game.LoadBoard(board);
+  }
+  if (!options.mute) {
+    game.EnableAudio();
+  }
+  if (options.measure_latency) {
+    game.EnableLatencyMeasurement(options.inject_keys);
+  }
+  if (!options.save_path.empty()) {
+    auto resume_start = std::chrono::steady_clock::now();
+    SaveFile save(options.save_path);
+    if (save.Valid() && game.Resume(save)) {
+      auto resume_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - resume_start);
+      std::cout << "Resumed game from " << options.save_path << " (score " << game.GetScore() << ", size "
+                << game.GetSize() << ") in " << resume_time.count() << " us\n";
+    }
+    game.EnableSaving(options.save_path);
+  }
+  if (options.autopilot) {
+    game.EnableAutoPilot();
+  }
+  if (options.sim_speed != 1.0) {
+    game.SetSimSpeed(options.sim_speed);
+  }
+  if (options.soak_seconds > 0) {
+    game.EnableSoak(SoakConfig{std::chrono::seconds(options.soak_seconds),
+                               std::chrono::seconds(options.soak_interval),
+                               options.soak_threshold});
+  }
+
+  // Optionally expose live metrics while the game runs.
+  std::unique_ptr<MetricsExporter> metrics_exporter;
+  if (options.metrics_port > 0) {
+    metrics_exporter = std::make_unique<MetricsExporter>(options.metrics_port);
+  } else if (!options.metrics_socket.empty()) {
+    metrics_exporter = std::make_unique<MetricsExporter>(options.metrics_socket);
+  }
 
   // Run the game loop until termination.
   game.Run(std::move(controller), std::move(renderer), kMsPerFrame);
@@ -38,5 +123,5 @@ int main() {
   std::cout << "Score: " << game.GetScore() << "\n";
   std::cout << "Size: " << game.GetSize() << "\n";
 
-  return 0;
+  return game.SoakPassed() ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,97 @@
+#include "metrics.h"
+#include <iomanip>
+#include "processstats.h"
+
+namespace {
+
+constexpr std::uint64_t kMaxExportedBound = 100000000; ///< Largest bucket bound exported: 100 s in microseconds.
+
+/**
+ * @brief Writes the HELP and TYPE header of a metric.
+ */
+void WriteHeader(std::ostream &out, const char *name, const char *type, const char *help) {
+  out << "# HELP " << name << " " << help << "\n"
+      << "# TYPE " << name << " " << type << "\n";
+}
+
+/**
+ * @brief Writes a single-sample counter or gauge.
+ */
+template <typename T>
+void WriteScalar(std::ostream &out, const char *name, const char *type, const char *help, T value) {
+  WriteHeader(out, name, type, help);
+  out << name << " " << value << "\n";
+}
+
+/**
+ * @brief Writes a duration in microseconds as exact decimal seconds, e.g. 16777216 as 16.777216.
+ *
+ * Streaming the value as a double would round it to six significant digits, which can make adjacent
+ * bucket bounds print alike.
+ */
+void WriteSeconds(std::ostream &out, std::uint64_t us) {
+  const char fill = out.fill('0');
+  out << us / 1000000 << "." << std::setw(6) << us % 1000000;
+  out.fill(fill);
+}
+
+/**
+ * @brief Writes a microsecond histogram as a Prometheus histogram in seconds.
+ *
+ * Only the last bucket of each power of two is exported, which keeps scrapes small while staying
+ * compatible with the power-of-two "le" bounds. The count is derived from the buckets rather than
+ * read separately, so that the +Inf bucket and _count always agree even when values are recorded
+ * during the scrape.
+ */
+void WriteHistogram(std::ostream &out, const char *name, const char *help, const Histogram &histogram) {
+  WriteHeader(out, name, "histogram", help);
+  Histogram::Snapshot snapshot = histogram.Read();
+  std::uint64_t cumulative = 0;
+  for (int i = 0; i < Histogram::kBuckets; ++i) {
+    cumulative += snapshot.buckets[i];
+    std::uint64_t bound = Histogram::BucketUpperBound(i);
+    if (i % Histogram::kSubBuckets == Histogram::kSubBuckets - 1 && bound <= kMaxExportedBound) {
+      out << name << "_bucket{le=\"";
+      WriteSeconds(out, bound);
+      out << "\"} " << cumulative << "\n";
+    }
+  }
+  out << name << "_bucket{le=\"+Inf\"} " << cumulative << "\n"
+      << name << "_sum ";
+  WriteSeconds(out, snapshot.sum);
+  out << "\n" << name << "_count " << cumulative << "\n";
+}
+
+} // namespace
+
+/**
+ * @brief Returns the process-wide metrics, creating them on first use.
+ */
+Metrics &Metrics::Instance() {
+  static Metrics metrics;
+  return metrics;
+}
+
+/**
+ * @brief Writes all metrics in the Prometheus text exposition format.
+ *
+ * Process resource usage is sampled here rather than on the hot paths.
+ */
+void Metrics::WritePrometheus(std::ostream &out) const {
+  WriteScalar(out, "snake_frames_total", "counter", "Frames presented.", frames_total.load(std::memory_order_relaxed));
+  WriteScalar(out, "snake_sim_ticks_total", "counter", "Simulation updates.", sim_ticks_total.load(std::memory_order_relaxed));
+  WriteScalar(out, "snake_games_total", "counter", "Games started.", games_total.load(std::memory_order_relaxed));
+  WriteScalar(out, "snake_fps", "gauge", "Frames presented during the last second.", fps.load(std::memory_order_relaxed));
+  WriteScalar(out, "snake_score", "gauge", "Score of the current game.", score.load(std::memory_order_relaxed));
+  WriteScalar(out, "snake_size", "gauge", "Size of the snake in the current game.", snake_size.load(std::memory_order_relaxed));
+  WriteScalar(out, "snake_render_quality", "gauge", "Render quality level, 0 is full quality.", render_quality.load(std::memory_order_relaxed));
+
+  WriteHistogram(out, "snake_frame_time_seconds", "Time between consecutive frames.", frame_time_us);
+  WriteHistogram(out, "snake_render_time_seconds", "Time spent rendering a frame.", render_time_us);
+  WriteHistogram(out, "snake_tick_jitter_seconds", "Deviation of the simulation tick interval from its target.", tick_jitter_us);
+
+  ProcessStats process = ProcessStats::Read();
+  WriteScalar(out, "process_resident_memory_bytes", "gauge", "Resident memory size in bytes.", process.rss_bytes);
+  WriteScalar(out, "process_open_fds", "gauge", "Number of open file descriptors.", process.open_fds);
+  WriteScalar(out, "process_threads", "gauge", "Number of OS threads.", process.threads);
+}
@@ -0,0 +1,45 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include "histogram.h"
+
+/**
+ * @brief Process-wide game counters, gauges and histograms.
+ *
+ * Every member is updated with relaxed atomics from the hot paths (main loop and simulation thread),
+ * so updating costs a few nanoseconds and readers such as the metrics exporter never block the game.
+ */
+class Metrics {
+public:
+  /**
+   * @brief Returns the process-wide metrics.
+   */
+  static Metrics &Instance();
+
+  /**
+   * @brief Writes all metrics in the Prometheus text exposition format.
+   *
+   * @param out Stream to write to.
+   */
+  void WritePrometheus(std::ostream &out) const;
+
+  std::atomic<std::uint64_t> frames_total{0};    ///< Frames presented by the main loop.
+  std::atomic<std::uint64_t> sim_ticks_total{0}; ///< Simulation updates run by the snake thread.
+  std::atomic<std::uint64_t> games_total{0};     ///< Games started, including the first one.
+  std::atomic<int> fps{0};                       ///< Frames presented during the last full second.
+  std::atomic<int> score{0};                     ///< Score of the current game.
+  std::atomic<int> snake_size{1};                ///< Size of the snake in the current game.
+  std::atomic<int> render_quality{0};            ///< Quality level chosen by the render governor, 0 is full.
+
+  Histogram frame_time_us;  ///< Time between consecutive frame starts, in microseconds.
+  Histogram render_time_us; ///< Time spent in Renderer::Render, in microseconds.
+  Histogram tick_jitter_us; ///< Deviation of the simulation tick interval from its target, in microseconds.
+
+private:
+  Metrics() = default;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,176 @@
+#include "metricsexporter.h"
+#include <iostream>
+#include <sstream>
+#include "metrics.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#define SNAKE_HAVE_SOCKETS 1
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/**
+ * @brief Starts serving on 127.0.0.1:port. Only the loopback interface is bound.
+ *
+ * Setup failures are logged and leave the exporter inactive; the game runs without it.
+ *
+ * @param port TCP port to listen on.
+ */
+MetricsExporter::MetricsExporter(int port) {
+#ifdef SNAKE_HAVE_SOCKETS
+  listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    std::cerr << "Metrics socket could not be created: " << std::strerror(errno) << "\n";
+    return;
+  }
+  int reuse = 1;
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(static_cast<uint16_t>(port));
+  if (bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(listen_fd, 8) < 0) {
+    std::cerr << "Metrics exporter could not listen on port " << port << ": " << std::strerror(errno) << "\n";
+    close(listen_fd);
+    listen_fd = -1;
+    return;
+  }
+  std::cout << "Serving metrics on http://127.0.0.1:" << port << "/metrics\n";
+  server = std::thread(&MetricsExporter::Serve, this);
+#else
+  std::cerr << "Metrics exporter is not supported on this platform (port " << port << ")\n";
+#endif
+}
+
+/**
+ * @brief Starts serving on a Unix domain socket, replacing any stale socket file.
+ *
+ * @param socket_path Filesystem path of the socket.
+ */
+MetricsExporter::MetricsExporter(const std::string &socket_path) : socket_path(socket_path) {
+#ifdef SNAKE_HAVE_SOCKETS
+  sockaddr_un address{};
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Metrics socket path is too long: " << socket_path << "\n";
+    return;
+  }
+  listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    std::cerr << "Metrics socket could not be created: " << std::strerror(errno) << "\n";
+    return;
+  }
+
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+  unlink(socket_path.c_str());
+  if (bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(listen_fd, 8) < 0) {
+    std::cerr << "Metrics exporter could not listen on " << socket_path << ": " << std::strerror(errno) << "\n";
+    close(listen_fd);
+    listen_fd = -1;
+    return;
+  }
+  std::cout << "Serving metrics on unix socket " << socket_path << "\n";
+  server = std::thread(&MetricsExporter::Serve, this);
+#else
+  std::cerr << "Metrics exporter is not supported on this platform (" << socket_path << ")\n";
+#endif
+}
+
+/**
+ * @brief Stops the serving thread and closes the listening socket.
+ *
+ * The accept loop polls with a short timeout, so shutdown takes at most that long.
+ */
+MetricsExporter::~MetricsExporter() {
+  stopping = true;
+  if (server.joinable()) {
+    server.join();
+  }
+#ifdef SNAKE_HAVE_SOCKETS
+  if (listen_fd >= 0) {
+    close(listen_fd);
+    if (!socket_path.empty()) {
+      unlink(socket_path.c_str());
+    }
+  }
+#endif
+}
+
+/**
+ * @brief Accepts and answers clients one at a time until the exporter is destroyed.
+ */
+void MetricsExporter::Serve() {
+#ifdef SNAKE_HAVE_SOCKETS
+  pollfd listener{listen_fd, POLLIN, 0};
+  while (!stopping) {
+    if (poll(&listener, 1, 100) <= 0 || !(listener.revents & POLLIN)) {
+      continue;
+    }
+    int client = accept(listen_fd, nullptr, nullptr);
+    if (client >= 0) {
+      Respond(client);
+      close(client);
+    }
+  }
+#endif
+}
+
+/**
+ * @brief Reads the request from a client and writes the metrics response.
+ *
+ * The request is only read so that the client does not see a reset; its content is ignored. A slow
+ * client is given up on after a short send/receive timeout so it cannot stall other scrapes.
+ *
+ * @param client Connected client socket.
+ */
+void MetricsExporter::Respond(int client) {
+#ifdef SNAKE_HAVE_SOCKETS
+  timeval timeout{0, 200000};
+  setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  std::string request;
+  char buffer[1024];
+  while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+    ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+    if (received <= 0) {
+      break;
+    }
+    request.append(buffer, static_cast<std::size_t>(received));
+  }
+
+  std::ostringstream body;
+  Metrics::Instance().WritePrometheus(body);
+  const std::string content = body.str();
+  std::ostringstream response;
+  response << "HTTP/1.0 200 OK\r\n"
+           << "Content-Type: text/plain; version=0.0.4\r\n"
+           << "Content-Length: " << content.size() << "\r\n"
+           << "Connection: close\r\n\r\n"
+           << content;
+
+  const std::string data = response.str();
+  std::size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t written = send(client, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (written <= 0) {
+      break;
+    }
+    sent += static_cast<std::size_t>(written);
+  }
+#else
+  (void)client;
+#endif
+}
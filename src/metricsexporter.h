@@ -0,0 +1,55 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Serves Metrics in the Prometheus text format over HTTP on a local port or Unix socket.
+ *
+ * Requests are answered from a dedicated thread that only reads the atomic metrics, so a scrape never
+ * blocks the game loop or the simulation thread. Any request path returns the metrics.
+ */
+class MetricsExporter {
+public:
+  /**
+   * @brief Starts serving on 127.0.0.1:port.
+   *
+   * @param port TCP port to listen on.
+   */
+  explicit MetricsExporter(int port);
+
+  /**
+   * @brief Starts serving on a Unix domain socket, replacing any stale socket file.
+   *
+   * @param socket_path Filesystem path of the socket.
+   */
+  explicit MetricsExporter(const std::string &socket_path);
+
+  /**
+   * @brief Stops the serving thread and closes the listening socket.
+   */
+  ~MetricsExporter();
+
+  MetricsExporter(const MetricsExporter &) = delete;
+  MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+private:
+  /**
+   * @brief Accept loop run by the serving thread.
+   */
+  void Serve();
+
+  /**
+   * @brief Reads the request from a client and writes the metrics response.
+   */
+  void Respond(int client);
+
+  int listen_fd{-1};                ///< Listening socket, -1 if setup failed.
+  std::string socket_path;          ///< Unix socket path to unlink on shutdown, empty for TCP.
+  std::atomic<bool> stopping{false}; ///< Set by the destructor to end the accept loop.
+  std::thread server;               ///< Thread running Serve().
+};
+
+#endif // METRICS_EXPORTER_H
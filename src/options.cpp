@@ -0,0 +1,149 @@
+#include "options.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Prints the list of supported options.
+ */
+void PrintUsage(const char *program) {
+  std::cout << "Usage: " << program << " [options]\n"
+            << "  --measure-latency   Report input-to-photon latency of key presses on exit\n"
+            << "  --inject-keys N     Inject N synthetic key presses, measure their latency and quit\n"
+            << "  --metrics-port N    Serve Prometheus metrics on http://127.0.0.1:N/metrics\n"
+            << "  --metrics-socket P  Serve Prometheus metrics over HTTP on the Unix socket P\n"
+            << "  --soak SECONDS      Play unattended AI games offscreen and fail on resource or timing drift\n"
+            << "  --soak-interval S   Seconds between soak samples (default 10)\n"
+            << "  --soak-threshold P  Allowed growth of a soak metric in percent (default 10)\n"
+            << "  --mute              Disable sound effects\n"
+            << "  --speed N|max       Run the simulation at N times real time, or as fast as possible\n"
+            << "  --autopilot         Let the AI play and restart games automatically\n"
+            << "  --headless-verify N Simulate N steps without a display with both engines and compare\n"
+            << "  --seed N            Seed of the headless run (default random)\n"
+            << "  --save PATH         Save the game every second and resume an interrupted game from PATH\n"
+            << "  --board SPEC        Start from a board file, serpentine:WxH or tangled:WxH\n"
+            << "  --render-threads N  Prepare the drawing of very large snakes on N threads, up to 256 (default one per core)\n"
+            << "  --help              Show this message\n";
+}
+
+/**
+ * @brief Returns the value following an option, exiting if it is missing.
+ */
+const char *OptionValue(int argc, char *argv[], int &i) {
+  if (i + 1 >= argc) {
+    std::cerr << "Missing value for " << argv[i] << "\n";
+    std::exit(EXIT_FAILURE);
+  }
+  return argv[++i];
+}
+
+/**
+ * @brief Parses a strictly positive integer option value no larger than max, exiting if it is invalid.
+ */
+int PositiveInt(const char *option, const char *value, long max = std::numeric_limits<int>::max()) {
+  char *end = nullptr;
+  long parsed = std::strtol(value, &end, 10);
+  if (end == value || *end != '\0' || parsed <= 0 || parsed > max) {
+    std::cerr << "Invalid value for " << option << ": " << value << "\n";
+    std::exit(EXIT_FAILURE);
+  }
+  return static_cast<int>(parsed);
+}
+
+/**
+ * @brief Parses a strictly positive, finite number option value, exiting if it is invalid.
+ */
+double PositiveDouble(const char *option, const char *value) {
+  char *end = nullptr;
+  double parsed = std::strtod(value, &end);
+  if (end == value || *end != '\0' || !(parsed > 0.0) || std::isinf(parsed)) {
+    std::cerr << "Invalid value for " << option << ": " << value << "\n";
+    std::exit(EXIT_FAILURE);
+  }
+  return parsed;
+}
+
+/**
+ * @brief Parses a simulation speed: a positive multiple of real time, or "max" for infinity.
+ */
+double SimSpeed(const char *option, const char *value) {
+  if (std::string(value) == "max") {
+    return std::numeric_limits<double>::infinity();
+  }
+  char *end = nullptr;
+  double parsed = std::strtod(value, &end);
+  if (end == value || *end != '\0' || !(parsed > 0.0) || parsed > 1e6) {
+    std::cerr << "Invalid value for " << option << ": " << value << "\n";
+    std::exit(EXIT_FAILURE);
+  }
+  return parsed;
+}
+
+} // namespace
+
+/**
+ * @brief Parses the command line into GameOptions.
+ *
+ * @param argc Argument count as passed to main.
+ * @param argv Argument vector as passed to main.
+ * @return GameOptions Parsed options.
+ */
+GameOptions ParseOptions(int argc, char *argv[]) {
+  GameOptions options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--measure-latency") {
+      options.measure_latency = true;
+    } else if (arg == "--inject-keys") {
+      const char *value = OptionValue(argc, argv, i);
+      options.inject_keys = PositiveInt(arg.c_str(), value);
+      options.measure_latency = true;
+    } else if (arg == "--metrics-port") {
+      const char *value = OptionValue(argc, argv, i);
+      options.metrics_port = PositiveInt(arg.c_str(), value, 65535);
+    } else if (arg == "--metrics-socket") {
+      options.metrics_socket = OptionValue(argc, argv, i);
+    } else if (arg == "--soak") {
+      const char *value = OptionValue(argc, argv, i);
+      options.soak_seconds = PositiveInt(arg.c_str(), value);
+    } else if (arg == "--soak-interval") {
+      const char *value = OptionValue(argc, argv, i);
+      options.soak_interval = PositiveInt(arg.c_str(), value);
+    } else if (arg == "--soak-threshold") {
+      const char *value = OptionValue(argc, argv, i);
+      options.soak_threshold = PositiveDouble(arg.c_str(), value);
+    } else if (arg == "--mute") {
+      options.mute = true;
+    } else if (arg == "--speed") {
+      const char *value = OptionValue(argc, argv, i);
+      options.sim_speed = SimSpeed(arg.c_str(), value);
+    } else if (arg == "--autopilot") {
+      options.autopilot = true;
+    } else if (arg == "--headless-verify") {
+      const char *value = OptionValue(argc, argv, i);
+      options.headless_steps = PositiveInt(arg.c_str(), value);
+    } else if (arg == "--board") {
+      options.board = OptionValue(argc, argv, i);
+    } else if (arg == "--save") {
+      options.save_path = OptionValue(argc, argv, i);
+    } else if (arg == "--seed") {
+      const char *value = OptionValue(argc, argv, i);
+      options.seed = PositiveInt(arg.c_str(), value);
+    } else if (arg == "--render-threads") {
+      const char *value = OptionValue(argc, argv, i);
+      options.render_threads = PositiveInt(arg.c_str(), value, 256);
+    } else if (arg == "--help" || arg == "-h") {
+      PrintUsage(argv[0]);
+      std::exit(EXIT_SUCCESS);
+    } else {
+      std::cerr << "Unknown option: " << arg << "\n";
+      PrintUsage(argv[0]);
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  return options;
+}
@@ -0,0 +1,41 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <string>
+
+/**
+ * @brief Command line options selecting optional game modes.
+ *
+ * Every option defaults to the regular interactive game, so running the executable without arguments
+ * behaves exactly as before.
+ */
+struct GameOptions {
+  bool measure_latency{false}; ///< Measure input-to-photon latency of handled key presses.
+  int inject_keys{0};          ///< Number of synthetic key presses to inject before quitting (0 = none).
+  int metrics_port{0};         ///< Local TCP port serving Prometheus metrics (0 = disabled).
+  std::string metrics_socket;  ///< Unix socket path serving Prometheus metrics (empty = disabled).
+  int soak_seconds{0};         ///< Length of an unattended soak run in seconds (0 = regular game).
+  int soak_interval{10};       ///< Seconds between two soak samples.
+  double soak_threshold{10.0}; ///< Allowed growth of any soak metric, in percent.
+  bool mute{false};            ///< Disable sound effects.
+  double sim_speed{1.0};       ///< Simulation speed as a multiple of real time (infinity = as fast as possible).
+  bool autopilot{false};       ///< Let the AI steer the snake.
+  int headless_steps{0};       ///< Steps of a headless engine comparison to run instead of the game (0 = none).
+  int seed{0};                 ///< Seed of the headless run (0 = random).
+  std::string save_path;       ///< File the game is saved to and resumed from (empty = disabled).
+  std::string board;           ///< Board file or generator to start from (empty = new game).
+  int render_threads{0};       ///< Threads preparing the draw data of very large snakes (0 = one per core).
+};
+
+/**
+ * @brief Parses the command line into GameOptions.
+ *
+ * Prints a usage message and exits on --help or on an invalid argument.
+ *
+ * @param argc Argument count as passed to main.
+ * @param argv Argument vector as passed to main.
+ * @return GameOptions Parsed options.
+ */
+GameOptions ParseOptions(int argc, char *argv[]);
+
+#endif // OPTIONS_H
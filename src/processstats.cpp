@@ -0,0 +1,48 @@
+#include "processstats.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#endif
+
+/**
+ * @brief Samples the current resource usage of this process.
+ *
+ * RSS comes from /proc/self/statm, the thread count from /proc/self/status and the number of open
+ * file descriptors from the entries of /proc/self/fd.
+ *
+ * @return ProcessStats Current usage, all zero where it cannot be read.
+ */
+ProcessStats ProcessStats::Read() {
+  ProcessStats stats;
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  std::uint64_t pages = 0;
+  std::uint64_t resident = 0;
+  if (statm >> pages >> resident) {
+    stats.rss_bytes = resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+  }
+
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 8, "Threads:") == 0) {
+      stats.threads = std::stoi(line.substr(8));
+      break;
+    }
+  }
+
+  if (DIR *dir = opendir("/proc/self/fd")) {
+    while (dirent *entry = readdir(dir)) {
+      if (entry->d_name[0] != '.') {
+        stats.open_fds++;
+      }
+    }
+    closedir(dir);
+    stats.open_fds--; // The descriptor opendir itself holds.
+  }
+#endif
+  return stats;
+}
@@ -0,0 +1,22 @@
+#ifndef PROCESS_STATS_H
+#define PROCESS_STATS_H
+
+#include <cstdint>
+
+/**
+ * @brief Resource usage of the running process.
+ *
+ * Values are read from /proc on Linux; on other platforms every field stays 0.
+ */
+struct ProcessStats {
+  std::uint64_t rss_bytes{0}; ///< Resident set size in bytes.
+  int open_fds{0};            ///< Number of open file descriptors.
+  int threads{0};             ///< Number of threads.
+
+  /**
+   * @brief Samples the current resource usage of this process.
+   */
+  static ProcessStats Read();
+};
+
+#endif // PROCESS_STATS_H
@@ -1,6 +1,89 @@
 #include "renderer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
 #include <iostream>
 #include <string>
+#include "metrics.h"
+#include "tracer.h"
+
+namespace {
+
+/**
+ * @brief Human-readable name of a quality level, for the log.
+ */
+const char *QualityName(RenderGovernor::Quality quality) {
+  switch (quality) {
+    case RenderGovernor::Quality::kFull:
+      return "full";
+    case RenderGovernor::Quality::kNoBackground:
+      return "no background";
+    case RenderGovernor::Quality::kMergedRuns:
+      return "merged snake runs";
+    case RenderGovernor::Quality::kLowResolution:
+      return "half resolution";
+  }
+  return "unknown";
+}
+
+/**
+ * @brief Appends one rectangle per straight run of consecutive segments in [first, last).
+ *
+ * Consecutive segments that are adjacent in the same row or column extend the current run; a turn
+ * or a wrap around the grid edge starts a new one.
+ */
+void AppendRuns(std::deque<SDL_Point>::const_iterator first, std::deque<SDL_Point>::const_iterator last,
+                int cell_width, int cell_height, std::vector<SDL_Rect> &runs) {
+  const SDL_Point *previous = nullptr;
+  const std::size_t start = runs.size();
+  for (; first != last; ++first) {
+    const SDL_Point &point = *first;
+    if (previous && runs.size() > start) {
+      SDL_Rect &run = runs.back();
+      const bool horizontal = point.y == previous->y && std::abs(point.x - previous->x) == 1 &&
+                              run.h == cell_height;
+      const bool vertical = point.x == previous->x && std::abs(point.y - previous->y) == 1 &&
+                            run.w == cell_width;
+      if (horizontal) {
+        run.x = std::min(run.x, point.x * cell_width);
+        run.w += cell_width;
+        previous = &point;
+        continue;
+      }
+      if (vertical) {
+        run.y = std::min(run.y, point.y * cell_height);
+        run.h += cell_height;
+        previous = &point;
+        continue;
+      }
+    }
+    runs.push_back({point.x * cell_width, point.y * cell_height, cell_width, cell_height});
+    previous = &point;
+  }
+}
+
+/**
+ * @brief Extends a rectangle by another one of the same height in the same row, or of the same width in
+ * the same column, if they touch.
+ *
+ * @return true if the rectangles were joined.
+ */
+bool JoinRuns(SDL_Rect &run, const SDL_Rect &next) {
+  if (run.y == next.y && run.h == next.h && (run.x + run.w == next.x || next.x + next.w == run.x)) {
+    run.x = std::min(run.x, next.x);
+    run.w += next.w;
+    return true;
+  }
+  if (run.x == next.x && run.w == next.w && (run.y + run.h == next.y || next.y + next.h == run.y)) {
+    run.y = std::min(run.y, next.y);
+    run.h += next.h;
+    return true;
+  }
+  return false;
+}
+
+} // namespace
 
 /**
  * @brief Constructs a new Renderer object and initializes SDL components like the window, renderer, and textures.
@@ -22,7 +105,11 @@ Renderer::Renderer(const std::size_t screen_width,
       grid_height(grid_height),
       sdl_window(nullptr, SDL_DestroyWindow),
       sdl_renderer(nullptr, SDL_DestroyRenderer),
-      background_texture(nullptr, SDL_DestroyTexture) {
+      background_texture(nullptr, SDL_DestroyTexture),
+      low_resolution_target(nullptr, SDL_DestroyTexture),
+      grid_resolution_target(nullptr, SDL_DestroyTexture),
+      cell_width(static_cast<int>(screen_width / grid_width)),
+      cell_height(static_cast<int>(screen_height / grid_height)) {
   // Initialize SDL
   if (SDL_Init(SDL_INIT_VIDEO) < 0) {
     std::cerr << "SDL could not initialize.\n";
@@ -40,8 +127,12 @@ Renderer::Renderer(const std::size_t screen_width,
     std::exit(EXIT_FAILURE);
   }
 
-  // Create renderer
+  // Create renderer, falling back to the software renderer when no accelerated one is available
+  // (e.g. with SDL_VIDEODRIVER=dummy in CI).
   sdl_renderer.reset(SDL_CreateRenderer(sdl_window.get(), -1, SDL_RENDERER_ACCELERATED));
+  if (nullptr == sdl_renderer) {
+    sdl_renderer.reset(SDL_CreateRenderer(sdl_window.get(), -1, SDL_RENDERER_SOFTWARE));
+  }
   if (nullptr == sdl_renderer) {
     std::cerr << "Renderer could not be created.\n";
     std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
@@ -56,6 +147,16 @@ Renderer::Renderer(const std::size_t screen_width,
   }
   background_texture.reset(SDL_CreateTextureFromSurface(sdl_renderer.get(), background_surface));
   SDL_FreeSurface(background_surface);
+
+#ifdef SNAKE_HAVE_RENDER_GEOMETRY
+  // Generate the snake sprites; without them the snake is drawn as plain rectangles
+  sprites = std::make_unique<SnakeSprites>(sdl_renderer.get());
+  if (!sprites->Ready()) {
+    sprites.reset();
+  }
+#endif
+
+  workers = std::make_unique<RenderWorkers>(0);
 }
 
 /**
@@ -64,6 +165,11 @@ Renderer::Renderer(const std::size_t screen_width,
  * This destructor quits SDL and releases all resources associated with the renderer.
  */
 Renderer::~Renderer() {
+  low_resolution_target.reset();
+  grid_resolution_target.reset();
+#ifdef SNAKE_HAVE_RENDER_GEOMETRY
+  sprites.reset();
+#endif
   SDL_Quit();
 }
 
@@ -71,24 +177,145 @@ Renderer::~Renderer() {
  * @brief Render the game state including the snake and food.
  * 
  * Clears the screen, draws the background, food, and snake, and presents the updated frame to the screen.
+ * The time from the start of the frame to the present is fed to the governor, which picks the quality
+ * of the next frame: the background is skipped first, then the textured snake is replaced by merged runs, and
+ * finally the scene is drawn into a half-resolution texture that is scaled up to the window. A grid with more
+ * cells than the window has pixels is drawn at one pixel per cell into a texture that is scaled down to
+ * the window, at every level.
  * 
  * @param snake Constant reference to the Snake object to be rendered.
  * @param food Constant reference to the SDL_Point object representing the food's location.
  */
 void Renderer::Render(const Snake& snake, SDL_Point const &food) {
+  TRACE_SCOPE("Renderer::Render");
+  auto start = std::chrono::steady_clock::now();
+  const RenderGovernor::Quality quality = governor.Current();
+
+  SDL_Texture *target = nullptr;
+  if (quality >= RenderGovernor::Quality::kLowResolution) {
+    target = LowResolutionTarget();
+  }
+  if (target) {
+    cell_width = static_cast<int>(screen_width / 2 / grid_width);
+    cell_height = static_cast<int>(screen_height / 2 / grid_height);
+  } else if (grid_width > screen_width || grid_height > screen_height) {
+    // Cells are smaller than a pixel; without a target, draw one pixel per cell and clip at the window edge
+    target = GridResolutionTarget();
+    cell_width = 1;
+    cell_height = 1;
+  } else {
+    cell_width = static_cast<int>(screen_width / grid_width);
+    cell_height = static_cast<int>(screen_height / grid_height);
+  }
+  if (target) {
+    SDL_SetRenderTarget(sdl_renderer.get(), target);
+  }
+
   // Set background color and clear screen
   SDL_SetRenderDrawColor(sdl_renderer.get(), 0x1E, 0x1E, 0x1E, 0xFF);
   SDL_RenderClear(sdl_renderer.get());
   
   // Draw background texture
-  SDL_RenderCopy(sdl_renderer.get(), background_texture.get(), NULL, NULL);
+  if (quality < RenderGovernor::Quality::kNoBackground) {
+    SDL_RenderCopy(sdl_renderer.get(), background_texture.get(), NULL, NULL);
+  }
   
   // Draw food and snake
   DrawFood(food);
-  DrawSnake(snake);
+  if (quality >= RenderGovernor::Quality::kMergedRuns) {
+    DrawSnakeRuns(snake);
+  } else {
+    DrawSnake(snake);
+  }
+
+  // Scale the offscreen frame to the window
+  if (target) {
+    SDL_SetRenderTarget(sdl_renderer.get(), nullptr);
+    SDL_RenderCopy(sdl_renderer.get(), target, NULL, NULL);
+  }
   
   // Present the updated frame
   SDL_RenderPresent(sdl_renderer.get());
+
+  auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  if (governor.Record(cost)) {
+    std::cout << "Render quality: " << QualityName(governor.Current()) << "\n";
+    Metrics::Instance().render_quality.store(static_cast<int>(governor.Current()), std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Sets the render budget to half of the target frame duration.
+ * 
+ * @param target_frame_duration Target duration of each frame in milliseconds.
+ */
+void Renderer::SetFrameBudget(std::size_t target_frame_duration) {
+  governor.SetBudget(std::chrono::microseconds(target_frame_duration * 1000 / 2));
+  Metrics::Instance().render_quality.store(static_cast<int>(governor.Current()), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Replaces the render workers with a pool of the given size.
+ * 
+ * The pool starts its threads on first use, so this is cheap before the first very large frame.
+ * 
+ * @param threads Threads including the main thread.
+ */
+void Renderer::SetRenderThreads(unsigned threads) {
+  workers = std::make_unique<RenderWorkers>(threads);
+}
+
+/**
+ * @brief Returns the half-resolution render target, creating it on first use.
+ * 
+ * If the renderer cannot render to textures, or a grid cell would be smaller than a pixel at half
+ * resolution, the level falls back to the resolution of the previous levels with their cheaper drawing.
+ * 
+ * @return The target texture, or nullptr if it is unavailable.
+ */
+SDL_Texture *Renderer::LowResolutionTarget() {
+  if (low_resolution_target || low_resolution_unavailable) {
+    return low_resolution_target.get();
+  }
+  const int width = static_cast<int>(screen_width / 2);
+  const int height = static_cast<int>(screen_height / 2);
+  if (!SDL_RenderTargetSupported(sdl_renderer.get()) ||
+      width / static_cast<int>(grid_width) == 0 || height / static_cast<int>(grid_height) == 0) {
+    low_resolution_unavailable = true;
+    return nullptr;
+  }
+  low_resolution_target.reset(SDL_CreateTexture(sdl_renderer.get(), SDL_PIXELFORMAT_ARGB8888,
+                                                SDL_TEXTUREACCESS_TARGET, width, height));
+  if (!low_resolution_target) {
+    std::cerr << "Low-resolution render target could not be created. SDL_Error: " << SDL_GetError() << "\n";
+    low_resolution_unavailable = true;
+  }
+  return low_resolution_target.get();
+}
+
+/**
+ * @brief Returns the render target with one pixel per cell, creating it on first use.
+ * 
+ * If the renderer cannot render to textures, the grid is drawn straight to the window at one pixel per
+ * cell and only its top left part is visible.
+ * 
+ * @return The target texture, or nullptr if it is unavailable.
+ */
+SDL_Texture *Renderer::GridResolutionTarget() {
+  if (grid_resolution_target || grid_resolution_unavailable) {
+    return grid_resolution_target.get();
+  }
+  if (SDL_RenderTargetSupported(sdl_renderer.get())) {
+    grid_resolution_target.reset(SDL_CreateTexture(sdl_renderer.get(), SDL_PIXELFORMAT_ARGB8888,
+                                                   SDL_TEXTUREACCESS_TARGET, static_cast<int>(grid_width),
+                                                   static_cast<int>(grid_height)));
+  }
+  if (!grid_resolution_target) {
+    std::cerr << "Grid-resolution render target could not be created, only part of the grid is shown. SDL_Error: "
+              << SDL_GetError() << "\n";
+    grid_resolution_unavailable = true;
+  }
+  return grid_resolution_target.get();
 }
 
 /**
@@ -100,10 +327,10 @@ void Renderer::Render(const Snake& snake, SDL_Point const &food) {
  */
 void Renderer::DrawFood(const SDL_Point &food) {
     SDL_Rect block = {
-        static_cast<int>(food.x * (screen_width / grid_width)),
-        static_cast<int>(food.y * (screen_height / grid_height)),
-        static_cast<int>(screen_width / grid_width),
-        static_cast<int>(screen_height / grid_height)
+        food.x * cell_width,
+        food.y * cell_height,
+        cell_width,
+        cell_height
     };
     SDL_SetRenderDrawColor(sdl_renderer.get(), 0xFF, 0xCC, 0x00, 0xFF);
     SDL_RenderFillRect(sdl_renderer.get(), &block);
@@ -112,29 +339,44 @@ void Renderer::DrawFood(const SDL_Point &food) {
 /**
  * @brief Draws the snake on the grid.
  * 
- * Renders each segment of the snake's body and the snake's head on the game grid. The color of the head
- * changes based on whether the snake is alive or dead.
+ * Draws the snake from its sprites when they are available. Snakes too long for the sprite ring are drawn
+ * as merged runs. Otherwise renders each segment of the snake's body and the snake's head as a rectangle. The color of the head changes based
+ * on whether the snake is alive or dead.
  * 
  * @param snake Constant reference to the Snake object to be rendered.
  */
 void Renderer::DrawSnake(const Snake &snake) {
+#ifdef SNAKE_HAVE_RENDER_GEOMETRY
+  if (sprites && snake.body.size() >= SnakeSprites::kMaxSegments) {
+    DrawSnakeRuns(snake);
+    return;
+  }
+  if (sprites) {
+    if (sprites->Draw(snake, cell_width, cell_height, *workers)) {
+      return;
+    }
+    std::cerr << "Snake sprites could not be drawn, using rectangles. SDL_Error: " << SDL_GetError() << "\n";
+    sprites.reset();
+  }
+#endif
+
   SDL_Rect block = {
         0, 0,
-        static_cast<int>(screen_width / grid_width),
-        static_cast<int>(screen_height / grid_height)
+        cell_width,
+        cell_height
     };
   
   // Draw each body segment
   for (const SDL_Point &point : snake.body) {
-    block.x = point.x * (screen_width / grid_width);
-    block.y = point.y * (screen_height / grid_height);
+    block.x = point.x * cell_width;
+    block.y = point.y * cell_height;
     SDL_SetRenderDrawColor(sdl_renderer.get(), 0xFF, 0xFF, 0xFF, 0xFF);
     SDL_RenderFillRect(sdl_renderer.get(), &block);
   }
 
   // Draw the snake's head
-  block.x = static_cast<int>(snake.head_x) * (screen_width / grid_width);
-  block.y = static_cast<int>(snake.head_y) * (screen_height / grid_height);
+  block.x = static_cast<int>(snake.head_x) * cell_width;
+  block.y = static_cast<int>(snake.head_y) * cell_height;
   SDL_SetRenderDrawColor(sdl_renderer.get(), 
                          snake.alive ? 0x00 : 0xFF,
                          snake.alive ? 0x7A : 0x00,
@@ -143,6 +385,48 @@ void Renderer::DrawSnake(const Snake &snake) {
   SDL_RenderFillRect(sdl_renderer.get(), &block);
 }
 
+/**
+ * @brief Draws the snake with one rectangle per straight run of body segments.
+ * 
+ * All runs are submitted in one call, followed by the head. Very long bodies are split into chunks
+ * whose runs are merged in parallel and then concatenated in chunk order, so the rectangles do not
+ * depend on the thread count. The halves of a run that crosses a chunk boundary are joined again when
+ * they line up.
+ * 
+ * @param snake Constant reference to the Snake object to be rendered.
+ */
+void Renderer::DrawSnakeRuns(const Snake &snake) {
+  runs.clear();
+  const std::size_t length = snake.body.size();
+  if (length < RenderWorkers::kParallelThreshold) {
+    AppendRuns(snake.body.begin(), snake.body.end(), cell_width, cell_height, runs);
+  } else {
+    chunk_runs.resize(RenderWorkers::Chunks(length));
+    workers->ForEachChunk(length, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+      chunk_runs[chunk].clear();
+      AppendRuns(snake.body.begin() + begin, snake.body.begin() + end, cell_width, cell_height, chunk_runs[chunk]);
+    });
+    for (const std::vector<SDL_Rect> &chunk : chunk_runs) {
+      auto first = chunk.begin();
+      if (!runs.empty() && first != chunk.end() && JoinRuns(runs.back(), *first)) {
+        ++first;
+      }
+      runs.insert(runs.end(), first, chunk.end());
+    }
+  }
+  SDL_SetRenderDrawColor(sdl_renderer.get(), 0xFF, 0xFF, 0xFF, 0xFF);
+  SDL_RenderFillRects(sdl_renderer.get(), runs.data(), static_cast<int>(runs.size()));
+
+  SDL_Rect head = {static_cast<int>(snake.head_x) * cell_width, static_cast<int>(snake.head_y) * cell_height,
+                   cell_width, cell_height};
+  SDL_SetRenderDrawColor(sdl_renderer.get(),
+                         snake.alive ? 0x00 : 0xFF,
+                         snake.alive ? 0x7A : 0x00,
+                         snake.alive ? 0xCC : 0x00,
+                         0xFF);
+  SDL_RenderFillRect(sdl_renderer.get(), &head);
+}
+
 /**
  * @brief Updates the window title with the current score and frames per second.
  * 
@@ -150,8 +434,12 @@ void Renderer::DrawSnake(const Snake &snake) {
  * 
  * @param score Current game score.
  * @param fps Current frames per second.
+ * @param sim_speed Achieved simulation speed as a multiple of real time, 0 to leave it out.
  */
-void Renderer::UpdateWindowTitle(int score, int fps) {
+void Renderer::UpdateWindowTitle(int score, int fps, double sim_speed) {
   std::string title{"Snake Score: " + std::to_string(score) + " FPS: " + std::to_string(fps)};
+  if (sim_speed > 0.0) {
+    title += " Speed: " + std::to_string(static_cast<int>(sim_speed + 0.5)) + "x";
+  }
   SDL_SetWindowTitle(sdl_window.get(), title.c_str());
 }
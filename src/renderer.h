@@ -5,7 +5,10 @@
 #include <memory>
 #include "SDL.h"
 #include "SDL_image.h"
+#include "rendergovernor.h"
+#include "renderworkers.h"
 #include "snake.h"
+#include "snakesprites.h"
 
 /**
  * @brief Handles rendering of game elements to the screen using SDL.
@@ -40,6 +43,8 @@ class Renderer {
    * @brief Render the snake and food on the game window.
    * 
    * This function clears the screen, draws the snake and food, and then presents the updated frame.
+   * The snake must not change during the call: the render workers read its body from other threads. The
+   * game passes a copy it took under its lock (see Snake::Mirror), so the snake thread keeps running.
    * 
    * @param snake Constant reference to the Snake object to be rendered.
    * @param food Constant reference to the SDL_Point where food is located.
@@ -53,8 +58,26 @@ class Renderer {
    * 
    * @param score Current score in the game.
    * @param fps Frames per second currently being rendered.
+   * @param sim_speed Achieved simulation speed as a multiple of real time, 0 to leave it out.
    */
-  void UpdateWindowTitle(int score, int fps);
+  void UpdateWindowTitle(int score, int fps, double sim_speed = 0.0);
+
+  /**
+   * @brief Sets the frame duration the game loop targets, from which the render budget is derived.
+   *
+   * Half of the frame is reserved for rendering, leaving the rest for input handling and slack. A
+   * zero duration disables the governor and keeps full quality.
+   *
+   * @param target_frame_duration Target duration of each frame in milliseconds.
+   */
+  void SetFrameBudget(std::size_t target_frame_duration);
+
+  /**
+   * @brief Sets how many threads prepare the draw data of very large snakes.
+   *
+   * @param threads Threads including the main thread; 1 prepares everything on the main thread.
+   */
+  void SetRenderThreads(unsigned threads);
 
  private:
   /**
@@ -69,12 +92,33 @@ class Renderer {
   /**
    * @brief Draw the snake on the game grid.
    * 
-   * Renders the snake's body and head as textures on the game grid according to its current position.
+   * Renders the snake's body and head from the sprite atlas, or as rectangles if sprites are unavailable.
    * 
    * @param snake Constant reference to the Snake object to be rendered.
    */
   void DrawSnake(const Snake &snake);
 
+  /**
+   * @brief Draw the snake's body with one rectangle per straight run of segments, in a single call.
+   *
+   * @param snake Constant reference to the Snake object to be rendered.
+   */
+  void DrawSnakeRuns(const Snake &snake);
+
+  /**
+   * @brief Returns the half-resolution render target, creating it on first use.
+   *
+   * @return The target texture, or nullptr if render targets are not supported or the grid does not fit.
+   */
+  SDL_Texture *LowResolutionTarget();
+
+  /**
+   * @brief Returns the render target with one pixel per cell for grids larger than the window, creating it on first use.
+   *
+   * @return The target texture, or nullptr if render targets are not supported.
+   */
+  SDL_Texture *GridResolutionTarget();
+
   const std::size_t screen_width;   ///< Width of the screen.
   const std::size_t screen_height;  ///< Height of the screen.
   const std::size_t grid_width;     ///< Width of the game grid.
@@ -83,6 +127,22 @@ class Renderer {
   std::unique_ptr<SDL_Window, void(*)(SDL_Window*)> sdl_window;       ///< Smart pointer managing the SDL_Window.
   std::unique_ptr<SDL_Renderer, void(*)(SDL_Renderer*)> sdl_renderer; ///< Smart pointer managing the SDL_Renderer.
   std::unique_ptr<SDL_Texture, void(*)(SDL_Texture*)> background_texture; ///< Smart pointer for managing a texture used as the background.
+  std::unique_ptr<SDL_Texture, void(*)(SDL_Texture*)> low_resolution_target; ///< Half-resolution target, created on first use.
+  bool low_resolution_unavailable{false}; ///< Set once creating the low-resolution target has failed.
+  std::unique_ptr<SDL_Texture, void(*)(SDL_Texture*)> grid_resolution_target; ///< One pixel per cell, for grids larger than the window.
+  bool grid_resolution_unavailable{false}; ///< Set once creating the grid-resolution target has failed.
+
+  int cell_width;   ///< Width of a grid cell in pixels on the current render target.
+  int cell_height;  ///< Height of a grid cell in pixels on the current render target.
+  std::vector<SDL_Rect> runs; ///< Rectangles of the merged snake runs, reused across frames.
+  std::vector<std::vector<SDL_Rect>> chunk_runs; ///< Runs of each chunk when they are merged in parallel.
+  std::unique_ptr<RenderWorkers> workers; ///< Threads preparing draw data for very large snakes.
+
+  RenderGovernor governor; ///< Adapts the render quality to the render budget.
+
+#ifdef SNAKE_HAVE_RENDER_GEOMETRY
+  std::unique_ptr<SnakeSprites> sprites; ///< Textured snake for the top quality levels, nullptr if unavailable.
+#endif
 };
 
 #endif // RENDERER_H
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "rendergovernor.h"
+#include <algorithm>
+
+/**
+ * @brief Sets the time rendering may take per frame and restarts at full quality.
+ *
+ * @param budget Render budget per frame; zero disables the governor.
+ */
+void RenderGovernor::SetBudget(std::chrono::microseconds budget) {
+  this->budget = budget;
+  quality = Quality::kFull;
+  average_us = 0.0;
+  over_budget = 0;
+  with_headroom = 0;
+  restore_frames = kRestoreFrames;
+  since_restore = kMaxRestoreFrames;
+  reseed = true;
+}
+
+/**
+ * @brief Feeds the cost of the frame just rendered and adjusts the quality.
+ *
+ * Degrading reacts within kDegradeFrames so that a slow frame rate is corrected quickly, while
+ * restoring waits for sustained headroom. After every change the average restarts from the first
+ * frame rendered at the new level, so costs of the old level do not trigger a second step. If a
+ * restored level is dropped again before it has been held for as long as the wait that preceded it,
+ * the next wait is doubled.
+ *
+ * @param cost Time the frame took to render and present.
+ * @return true if the quality changed.
+ */
+bool RenderGovernor::Record(std::chrono::microseconds cost) {
+  if (budget.count() <= 0) {
+    return false;
+  }
+
+  if (reseed) {
+    average_us = static_cast<double>(cost.count());
+    reseed = false;
+  } else {
+    average_us += kSmoothing * (static_cast<double>(cost.count()) - average_us);
+  }
+  since_restore++;
+  const double budget_us = static_cast<double>(budget.count());
+
+  over_budget = average_us > budget_us ? over_budget + 1 : 0;
+  with_headroom = average_us < kHeadroom * budget_us ? with_headroom + 1 : 0;
+
+  if (over_budget >= kDegradeFrames && quality != Quality::kLowResolution) {
+    if (since_restore < restore_frames) {
+      restore_frames = std::min(restore_frames * 2, kMaxRestoreFrames);
+    }
+    quality = static_cast<Quality>(static_cast<int>(quality) + 1);
+    over_budget = 0;
+    with_headroom = 0;
+    reseed = true;
+    return true;
+  }
+
+  if (with_headroom >= restore_frames && quality != Quality::kFull) {
+    quality = static_cast<Quality>(static_cast<int>(quality) - 1);
+    over_budget = 0;
+    with_headroom = 0;
+    since_restore = 0;
+    reseed = true;
+    return true;
+  }
+  return false;
+}
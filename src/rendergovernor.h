@@ -0,0 +1,68 @@
+#ifndef RENDER_GOVERNOR_H
+#define RENDER_GOVERNOR_H
+
+#include <chrono>
+
+/**
+ * @brief Adapts render quality to the time each frame takes to render.
+ *
+ * The governor keeps a moving average of the render cost. When it stays above the render budget,
+ * quality drops one step; when it stays well below, quality is restored one step. A level that had
+ * to be abandoned again shortly after being restored waits twice as long before the next attempt, so
+ * the governor does not oscillate on hardware that sits right at the edge.
+ */
+class RenderGovernor {
+public:
+  /**
+   * @brief Render quality levels, from best to cheapest. Each level includes the savings of the previous ones.
+   */
+  enum class Quality {
+    kFull,          ///< Background texture and the textured snake.
+    kNoBackground,  ///< Skip the background texture.
+    kMergedRuns,    ///< Draw straight runs of the snake as plain rectangles in one call.
+    kLowResolution, ///< Render at half resolution and scale up.
+  };
+
+  /**
+   * @brief Construct a governor that is disabled until a budget is set.
+   */
+  RenderGovernor() = default;
+
+  /**
+   * @brief Sets the time rendering may take per frame. A zero budget disables the governor.
+   *
+   * @param budget Render budget per frame.
+   */
+  void SetBudget(std::chrono::microseconds budget);
+
+  /**
+   * @brief Returns the quality the next frame should be rendered at.
+   */
+  Quality Current() const { return quality; }
+
+  /**
+   * @brief Feeds the cost of the frame just rendered and adjusts the quality.
+   *
+   * @param cost Time the frame took to render and present.
+   * @return true if the quality changed.
+   */
+  bool Record(std::chrono::microseconds cost);
+
+private:
+  static constexpr double kSmoothing = 0.1;        ///< Weight of the newest frame in the moving average.
+  static constexpr int kDegradeFrames = 10;        ///< Frames over budget before dropping a level.
+  static constexpr int kRestoreFrames = 120;       ///< Initial frames with headroom before restoring a level.
+  static constexpr int kMaxRestoreFrames = 1920;   ///< Longest wait before restoring a level.
+  static constexpr double kHeadroom = 0.5;         ///< Fraction of the budget the cost must stay under to restore.
+
+  std::chrono::microseconds budget{0};  ///< Render budget per frame, 0 when disabled.
+  Quality quality{Quality::kFull};      ///< Current quality level.
+  double average_us{0.0};               ///< Moving average of the render cost.
+  int over_budget{0};                   ///< Consecutive frames with the average over budget.
+  int with_headroom{0};                 ///< Consecutive frames with the average well under budget.
+  int restore_frames{kRestoreFrames};   ///< Frames of headroom currently required to restore.
+  int since_restore{kMaxRestoreFrames}; ///< Frames rendered since the last restore.
+  bool reseed{true};                    ///< Restart the average from the next frame, after a level change.
+};
+
+#endif // RENDER_GOVERNOR_H
@@ -0,0 +1,120 @@
+#include "renderworkers.h"
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <system_error>
+#include "tracer.h"
+
+/**
+ * @brief Construct a new RenderWorkers pool. No thread is started yet.
+ *
+ * @param threads Threads preparing a frame, including the caller; 0 picks one per core.
+ */
+RenderWorkers::RenderWorkers(unsigned threads)
+    : threads(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads) {}
+
+/**
+ * @brief Stops and joins the workers.
+ */
+RenderWorkers::~RenderWorkers() {
+  {
+    std::lock_guard<ProfiledMutex> lock(mutex);
+    stopping = true;
+  }
+  start.notify_all();
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+}
+
+/**
+ * @brief Starts the workers.
+ *
+ * A failure to create a thread is logged and leaves the pool with the workers started so far.
+ */
+void RenderWorkers::Start() {
+  try {
+    for (unsigned i = 1; i < threads; ++i) {
+      workers.emplace_back(&RenderWorkers::Work, this);
+    }
+  } catch (const std::system_error &error) {
+    std::cerr << "Only " << workers.size() + 1 << " of " << threads
+              << " render threads could be started: " << error.what() << "\n";
+    threads = static_cast<unsigned>(workers.size()) + 1;
+  }
+}
+
+/**
+ * @brief Runs a job for every chunk of a range of items and returns once all chunks are done.
+ *
+ * The caller takes chunks as well, so a frame never waits for a worker to wake up before work begins.
+ *
+ * @param items Number of items.
+ * @param job Work to do per chunk; called concurrently for different chunks.
+ */
+void RenderWorkers::ForEachChunk(std::size_t items, const Job &job) {
+  if (threads > 1 && workers.empty() && items >= kParallelThreshold) {
+    Start();
+  }
+  if (workers.empty() || items < kParallelThreshold) {
+    for (std::size_t chunk = 0, count = Chunks(items); chunk < count; ++chunk) {
+      job(chunk, chunk * kChunkSize, std::min(items, (chunk + 1) * kChunkSize));
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<ProfiledMutex> lock(mutex);
+    this->job = &job;
+    this->items = items;
+    chunks = Chunks(items);
+    next.store(0, std::memory_order_relaxed);
+    busy = static_cast<unsigned>(workers.size());
+    round++;
+  }
+  start.notify_all();
+  RunChunks();
+
+  ProfiledUniqueLock lock(mutex);
+  finished.wait(lock, [this]() { return busy == 0; });
+  this->job = nullptr;
+}
+
+/**
+ * @brief Takes chunks of the current job until none are left.
+ */
+void RenderWorkers::RunChunks() {
+  TRACE_SCOPE("RenderWorkers::RunChunks");
+  for (std::size_t chunk = next.fetch_add(1, std::memory_order_relaxed); chunk < chunks;
+       chunk = next.fetch_add(1, std::memory_order_relaxed)) {
+    (*job)(chunk, chunk * kChunkSize, std::min(items, (chunk + 1) * kChunkSize));
+  }
+}
+
+/**
+ * @brief Waits for jobs and helps with them until the pool is destroyed.
+ *
+ * A worker joins every round exactly once, even if it wakes up after the other threads took all chunks;
+ * the caller waits for all of them, so the job outlives every access to it.
+ */
+void RenderWorkers::Work() {
+  TRACE_THREAD_NAME("renderWorker");
+  std::uint64_t seen = 0;
+  while (true) {
+    {
+      ProfiledUniqueLock lock(mutex);
+      start.wait(lock, [this, seen]() { return stopping || round != seen; });
+      if (stopping) {
+        return;
+      }
+      seen = round;
+    }
+
+    RunChunks();
+
+    std::lock_guard<ProfiledMutex> lock(mutex);
+    if (--busy == 0) {
+      finished.notify_one();
+    }
+  }
+}
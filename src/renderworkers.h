@@ -0,0 +1,98 @@
+#ifndef RENDER_WORKERS_H
+#define RENDER_WORKERS_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "lockprofiler.h"
+
+/**
+ * @brief A persistent pool of threads that prepares render data for very large scenes.
+ *
+ * The work is split into fixed-size chunks of items. The calling thread and the workers take chunks from
+ * a shared atomic counter until none are left, so faster threads simply take more of them. Each chunk
+ * writes to its own output, which the caller combines in chunk order afterwards; the result does not
+ * depend on which thread handled which chunk. Only preparation runs here: all SDL calls stay on the
+ * main thread, as the SDL renderer requires.
+ *
+ * The threads are only started the first time a job is large enough to be split, so games that never
+ * grow a very large snake do not pay for them.
+ */
+class RenderWorkers {
+public:
+  static constexpr std::size_t kChunkSize = 4096;        ///< Items per chunk.
+  static constexpr std::size_t kParallelThreshold = 16384; ///< Fewer items than this are prepared serially.
+
+  /**
+   * @brief Work done for one chunk: its index and the range of items it covers.
+   */
+  using Job = std::function<void(std::size_t chunk, std::size_t begin, std::size_t end)>;
+
+  /**
+   * @brief Construct a new RenderWorkers pool. No thread is started yet.
+   *
+   * @param threads Threads preparing a frame, including the caller; 0 picks one per core.
+   */
+  explicit RenderWorkers(unsigned threads);
+
+  /**
+   * @brief Stops and joins the workers.
+   */
+  ~RenderWorkers();
+
+  RenderWorkers(const RenderWorkers &) = delete;
+  RenderWorkers &operator=(const RenderWorkers &) = delete;
+
+  /**
+   * @brief Returns the number of threads preparing a frame, including the caller.
+   */
+  unsigned Threads() const { return threads; }
+
+  /**
+   * @brief Returns the number of chunks a range of items is split into.
+   */
+  static std::size_t Chunks(std::size_t items) { return (items + kChunkSize - 1) / kChunkSize; }
+
+  /**
+   * @brief Runs a job for every chunk of a range of items and returns once all chunks are done.
+   *
+   * Ranges below kParallelThreshold, or a pool without workers, run on the calling thread alone.
+   *
+   * @param items Number of items.
+   * @param job Work to do per chunk; called concurrently for different chunks.
+   */
+  void ForEachChunk(std::size_t items, const Job &job);
+
+private:
+  /**
+   * @brief Starts the workers. If the system runs out of threads, the pool shrinks to those started.
+   */
+  void Start();
+
+  /**
+   * @brief Takes chunks of the current job until none are left.
+   */
+  void RunChunks();
+
+  /**
+   * @brief Waits for jobs and helps with them until the pool is destroyed.
+   */
+  void Work();
+
+  unsigned threads;                       ///< Threads preparing a frame, including the caller.
+  std::vector<std::thread> workers;       ///< Threads besides the caller, started on the first large job.
+  ProfiledMutex mutex{"RenderWorkers::mutex"};
+  ProfiledConditionVariable start;        ///< Signals a new job or shutdown to the workers.
+  ProfiledConditionVariable finished;     ///< Signals the caller that the last worker is done.
+  const Job *job{nullptr};                ///< Job being run, valid while busy > 0.
+  std::size_t items{0};                   ///< Items of the job being run.
+  std::size_t chunks{0};                  ///< Chunks of the job being run.
+  std::atomic<std::size_t> next{0};       ///< Next chunk to take.
+  std::uint64_t round{0};                 ///< Incremented for every job, so workers join each job once.
+  unsigned busy{0};                       ///< Workers that have not finished the current job.
+  bool stopping{false};                   ///< Set when the pool is destroyed.
+};
+
+#endif // RENDER_WORKERS_H
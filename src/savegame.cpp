@@ -0,0 +1,303 @@
+#include "savegame.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#define SNAKE_HAVE_MMAP 1
+#endif
+
+namespace {
+
+constexpr char kSaveMagic[8] = {'S', 'N', 'A', 'K', 'E', 'S', 'A', 'V'};
+constexpr std::uint32_t kSaveVersion = 1;
+constexpr std::uint32_t kSaveByteOrder = 0x01020304;
+
+/**
+ * @brief Rounds a size up to a multiple of 8 bytes, keeping the following data aligned.
+ */
+constexpr std::size_t Align8(std::size_t size) { return (size + 7) & ~static_cast<std::size_t>(7); }
+
+constexpr std::size_t kRngOffset = Align8(sizeof(SaveHeader));
+constexpr std::size_t kBodyOffset = kRngOffset + Align8(sizeof(std::mt19937));
+
+#ifdef SNAKE_HAVE_MMAP
+/**
+ * @brief Writes the whole buffer, retrying on short writes and interrupts.
+ */
+bool WriteAll(int fd, const unsigned char *data, std::size_t length) {
+  while (length > 0) {
+    ssize_t written = ::write(fd, data, length);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    data += written;
+    length -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+#endif
+
+} // namespace
+
+/**
+ * @brief Builds the bytes of a save file from the game state.
+ *
+ * @param snake Snake to save; must be alive.
+ * @param food Current food position.
+ * @param score Current score.
+ * @param engine Food RNG.
+ * @param image Buffer that receives the file contents.
+ */
+void BuildSaveImage(const Snake &snake, const SDL_Point &food, int score, const std::mt19937 &engine,
+                    std::vector<unsigned char> &image) {
+  SaveHeader header{};
+  std::memcpy(header.magic, kSaveMagic, sizeof(header.magic));
+  header.version = kSaveVersion;
+  header.byte_order = kSaveByteOrder;
+  header.header_size = sizeof(SaveHeader);
+  header.rng_size = sizeof(std::mt19937);
+  header.grid_width = snake.GetGridWidth();
+  header.grid_height = snake.GetGridHeight();
+  header.head_x = snake.head_x;
+  header.head_y = snake.head_y;
+  header.speed = snake.speed;
+  header.direction = static_cast<std::int32_t>(snake.direction);
+  header.size = snake.size;
+  header.growing = snake.IsGrowing() ? 1 : 0;
+  header.score = score;
+  header.food = food;
+  header.body_length = snake.body.size();
+
+  image.assign(kBodyOffset + snake.body.size() * sizeof(SDL_Point), 0);
+  std::memcpy(image.data(), &header, sizeof(header));
+  std::memcpy(image.data() + kRngOffset, &engine, sizeof(engine));
+  unsigned char *out = image.data() + kBodyOffset;
+  for (const SDL_Point &point : snake.body) {
+    std::memcpy(out, &point, sizeof(point));
+    out += sizeof(point);
+  }
+}
+
+/**
+ * @brief Returns true if a file starts with the save file signature.
+ *
+ * @param path File to check.
+ */
+bool IsSaveFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  char magic[sizeof(kSaveMagic)] = {};
+  return file.read(magic, sizeof(magic)) && std::memcmp(magic, kSaveMagic, sizeof(magic)) == 0;
+}
+
+/**
+ * @brief Maps the file and checks its header against the file size and the rules of the game.
+ *
+ * @param path Path of the save file.
+ */
+SaveFile::SaveFile(const std::string &path) {
+#ifdef SNAKE_HAVE_MMAP
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+    void *mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+      data = static_cast<const unsigned char *>(mapping);
+      length = static_cast<std::size_t>(info.st_size);
+      mapped = true;
+    }
+  }
+  ::close(fd);
+#else
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return;
+  }
+  buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  data = buffer.data();
+  length = buffer.size();
+#endif
+  if (!data) {
+    return;
+  }
+
+  const char *problem = nullptr;
+  if (length < kBodyOffset) {
+    problem = "file too short";
+  } else {
+    const SaveHeader &header = Header();
+    if (std::memcmp(header.magic, kSaveMagic, sizeof(kSaveMagic)) != 0) {
+      problem = "not a save file";
+    } else if (header.version != kSaveVersion || header.byte_order != kSaveByteOrder ||
+               header.header_size != sizeof(SaveHeader) || header.rng_size != sizeof(std::mt19937)) {
+      problem = "written by an incompatible version";
+    } else if (header.body_length > (length - kBodyOffset) / sizeof(SDL_Point) ||
+               length != kBodyOffset + header.body_length * sizeof(SDL_Point)) {
+      problem = "size does not match the body length";
+    } else if (header.grid_width <= 0 || header.grid_height <= 0 || header.direction < 0 || header.direction > 3 ||
+               static_cast<std::uint64_t>(header.size) != header.body_length + 1 ||
+               !(header.speed > 0.0f) || !std::isfinite(header.speed) ||
+               !(header.head_x >= 0.0f && header.head_x < header.grid_width) ||
+               !(header.head_y >= 0.0f && header.head_y < header.grid_height) ||
+               header.food.x < 0 || header.food.x >= header.grid_width ||
+               header.food.y < 0 || header.food.y >= header.grid_height || header.score < 0) {
+      problem = "state out of range";
+    }
+  }
+  if (problem) {
+    std::cerr << "Ignoring save file " << path << ": " << problem << "\n";
+    return;
+  }
+  valid = true;
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+SaveFile::~SaveFile() {
+#ifdef SNAKE_HAVE_MMAP
+  if (mapped) {
+    ::munmap(const_cast<unsigned char *>(data), length);
+  }
+#endif
+}
+
+/**
+ * @brief Copies the saved RNG state into an engine.
+ *
+ * @param engine Engine to overwrite.
+ */
+void SaveFile::RestoreEngine(std::mt19937 &engine) const {
+  std::memcpy(&engine, data + kRngOffset, sizeof(engine));
+}
+
+/**
+ * @brief Returns the saved body. The offset is 8-byte aligned within a page-aligned mapping.
+ */
+const SDL_Point *SaveFile::Body() const {
+  return reinterpret_cast<const SDL_Point *>(data + kBodyOffset);
+}
+
+/**
+ * @brief Starts the writer thread.
+ *
+ * @param path Path of the save file.
+ */
+SaveWriter::SaveWriter(std::string path) : path(std::move(path)), writer(&SaveWriter::Write, this) {}
+
+/**
+ * @brief Finishes any pending request and stops the writer thread.
+ */
+SaveWriter::~SaveWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  cv.notify_one();
+  writer.join();
+}
+
+/**
+ * @brief Hands an image to the writer thread, replacing any image it has not picked up yet.
+ *
+ * @param image Save file contents; receives the previous pending buffer for reuse.
+ */
+void SaveWriter::Submit(std::vector<unsigned char> &image) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.swap(image);
+    has_pending = true;
+    remove = false;
+  }
+  cv.notify_one();
+}
+
+/**
+ * @brief Drops any pending image and removes the save file.
+ */
+void SaveWriter::Discard() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    has_pending = false;
+    remove = true;
+  }
+  cv.notify_one();
+}
+
+/**
+ * @brief Writer thread: waits for requests and carries them out without holding the mutex.
+ */
+void SaveWriter::Write() {
+  std::vector<unsigned char> image;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    cv.wait(lock, [this]() { return stopping || has_pending || remove; });
+    if (has_pending) {
+      image.swap(pending);
+      has_pending = false;
+      lock.unlock();
+      if (!WriteFile(image)) {
+        std::cerr << "Game could not be saved to " << path << "\n";
+      }
+      lock.lock();
+    } else if (remove) {
+      remove = false;
+      lock.unlock();
+      std::remove(path.c_str());
+      lock.lock();
+    } else if (stopping) {
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Writes an image to <path>.tmp, flushes it to disk and renames it over the save file.
+ *
+ * The directory is flushed as well, so the rename itself survives a power cut.
+ */
+bool SaveWriter::WriteFile(const std::vector<unsigned char> &image) const {
+  const std::string temporary = path + ".tmp";
+#ifdef SNAKE_HAVE_MMAP
+  int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  bool written = WriteAll(fd, image.data(), image.size()) && ::fsync(fd) == 0;
+  written = ::close(fd) == 0 && written;
+  if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    return false;
+  }
+  const std::size_t slash = path.find_last_of('/');
+  const std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+  int directory_fd = ::open(directory.c_str(), O_RDONLY);
+  if (directory_fd >= 0) {
+    ::fsync(directory_fd);
+    ::close(directory_fd);
+  }
+  return true;
+#else
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(image.data()), static_cast<std::streamsize>(image.size()));
+    if (!file.flush()) {
+      return false;
+    }
+  }
+  std::remove(path.c_str());
+  return std::rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+}
@@ -0,0 +1,170 @@
+#ifndef SAVEGAME_H
+#define SAVEGAME_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "SDL.h"
+#include "snake.h"
+
+/**
+ * @brief Fixed-layout header at the start of a save file.
+ *
+ * A save file is the header, the raw bytes of the food RNG padded to 8 bytes, and the body as a flat
+ * array of SDL_Point from the segment behind the head to the tail. All fields are native-endian; the
+ * byte_order marker rejects files written on a machine with a different layout.
+ */
+struct SaveHeader {
+  char magic[8];              ///< kSaveMagic.
+  std::uint32_t version;      ///< kSaveVersion.
+  std::uint32_t byte_order;   ///< kSaveByteOrder as written by the saving machine.
+  std::uint32_t header_size;  ///< sizeof(SaveHeader).
+  std::uint32_t rng_size;     ///< sizeof(std::mt19937).
+  std::int32_t grid_width;    ///< Grid the game was played on.
+  std::int32_t grid_height;
+  float head_x;               ///< Head position, exactly as in Snake.
+  float head_y;
+  float speed;                ///< Snake speed in cells per second.
+  std::int32_t direction;     ///< Snake::Direction as an integer.
+  std::int32_t size;          ///< Snake size, always body_length + 1.
+  std::int32_t growing;       ///< Whether the snake grows on its next move.
+  std::int32_t score;         ///< Score of the game.
+  SDL_Point food;             ///< Current food position.
+  std::uint64_t body_length;  ///< Number of SDL_Point entries that follow the RNG.
+};
+
+static_assert(std::is_trivially_copyable<SaveHeader>::value, "SaveHeader must be written as raw bytes");
+static_assert(std::is_trivially_copyable<std::mt19937>::value, "std::mt19937 must be written as raw bytes");
+static_assert(std::is_trivially_copyable<SDL_Point>::value, "SDL_Point must be written as raw bytes");
+
+/**
+ * @brief Builds the bytes of a save file from the game state.
+ *
+ * Must be called with the game mutex held; only copies memory, so it is quick even for long snakes.
+ *
+ * @param snake Snake to save; must be alive.
+ * @param food Current food position.
+ * @param score Current score.
+ * @param engine Food RNG.
+ * @param image Buffer that receives the file contents; its capacity is reused.
+ */
+void BuildSaveImage(const Snake &snake, const SDL_Point &food, int score, const std::mt19937 &engine,
+                    std::vector<unsigned char> &image);
+
+/**
+ * @brief Returns true if a file starts with the save file signature, without validating the rest.
+ *
+ * @param path File to check.
+ */
+bool IsSaveFile(const std::string &path);
+
+/**
+ * @brief A save file mapped into memory and validated in constant time.
+ *
+ * Only the header and the file size are checked, so opening does not depend on the snake's length.
+ * The body is used straight from the mapping.
+ */
+class SaveFile {
+public:
+  /**
+   * @brief Maps and validates a save file. A missing file is not an error; an invalid one is logged.
+   *
+   * @param path Path of the save file.
+   */
+  explicit SaveFile(const std::string &path);
+
+  /**
+   * @brief Unmaps the file.
+   */
+  ~SaveFile();
+
+  SaveFile(const SaveFile &) = delete;
+  SaveFile &operator=(const SaveFile &) = delete;
+
+  /**
+   * @brief Returns true if the file exists and its header is valid.
+   */
+  bool Valid() const { return valid; }
+
+  /**
+   * @brief Returns the header. Only meaningful if Valid().
+   */
+  const SaveHeader &Header() const { return *reinterpret_cast<const SaveHeader *>(data); }
+
+  /**
+   * @brief Copies the saved RNG state into an engine.
+   *
+   * @param engine Engine to overwrite.
+   */
+  void RestoreEngine(std::mt19937 &engine) const;
+
+  /**
+   * @brief Returns the saved body, Header().body_length entries long.
+   */
+  const SDL_Point *Body() const;
+
+private:
+  const unsigned char *data{nullptr}; ///< Start of the mapping or buffer.
+  std::size_t length{0};              ///< Size of the file.
+  std::vector<unsigned char> buffer;  ///< File contents on platforms without mmap.
+  bool mapped{false};                 ///< Whether data must be unmapped.
+  bool valid{false};                  ///< Result of the validation.
+};
+
+/**
+ * @brief Writes save images to disk on a background thread, replacing the file atomically.
+ *
+ * Each image is written to <path>.tmp, flushed to disk and renamed over the save file, so a power cut
+ * leaves either the previous or the new save, never a partial one. Only the latest submitted image is
+ * written; older ones that were not yet picked up are dropped.
+ */
+class SaveWriter {
+public:
+  /**
+   * @brief Starts the writer thread.
+   *
+   * @param path Path of the save file.
+   */
+  explicit SaveWriter(std::string path);
+
+  /**
+   * @brief Finishes any pending request and stops the writer thread.
+   */
+  ~SaveWriter();
+
+  SaveWriter(const SaveWriter &) = delete;
+  SaveWriter &operator=(const SaveWriter &) = delete;
+
+  /**
+   * @brief Hands an image to the writer thread, which writes it as soon as possible.
+   *
+   * @param image Save file contents. Swapped with a spare buffer, so its capacity is reused.
+   */
+  void Submit(std::vector<unsigned char> &image);
+
+  /**
+   * @brief Drops any pending image and removes the save file, e.g. after a game over or a clean exit.
+   */
+  void Discard();
+
+private:
+  void Write();
+  bool WriteFile(const std::vector<unsigned char> &image) const;
+
+  const std::string path;             ///< Save file.
+  std::mutex mutex;                   ///< Guards the fields below.
+  std::condition_variable cv;         ///< Signals a new request to the writer thread.
+  std::vector<unsigned char> pending; ///< Latest image not yet written.
+  bool has_pending{false};            ///< Whether pending holds an image.
+  bool remove{false};                 ///< Whether the save file should be removed.
+  bool stopping{false};               ///< Set by the destructor.
+  std::thread writer;                 ///< Thread running Write().
+};
+
+#endif // SAVEGAME_H
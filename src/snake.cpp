@@ -1,6 +1,33 @@
 #include "snake.h"
 #include <cmath>
 #include <iostream>
+#include <limits>
+
+namespace {
+
+/**
+ * @brief Moves a coordinate by a distance and wraps it onto [0, size), in exact integer arithmetic.
+ *
+ * The coordinate is a multiple of 1/scale below size, so it converts to whole units and back without
+ * rounding. Summing in float instead would round once the sum leaves the range where floats resolve
+ * 1/scale, which happens for sums of 4096 cells and up.
+ *
+ * @param position Coordinate in cells.
+ * @param distance Signed distance in units of 1/scale cells.
+ * @param size Number of cells along the axis.
+ * @param scale Units per cell.
+ * @return float Moved and wrapped coordinate.
+ */
+float MoveWrapped(float position, std::int64_t distance, int size, float scale) {
+    const std::int64_t span = static_cast<std::int64_t>(size) * static_cast<std::int64_t>(scale);
+    std::int64_t units = (std::llround(position * scale) + distance) % span;
+    if (units < 0) {
+        units += span;
+    }
+    return static_cast<float>(units) / scale;
+}
+
+} // namespace
 
 /**
  * @brief Construct a new Snake object centered in the game grid.
@@ -42,24 +69,75 @@ void Snake::Update(float elapsed_time) {
  * @param elapsed_time The time elapsed since the last update, affecting the movement distance.
  */
 void Snake::UpdateHead(float elapsed_time) {
-    // Adjust position based on direction and speed * elapsed time
+    // Adjust position based on direction and speed * elapsed time, rounded to the position grid, and wrap the
+    // snake around to the opposite side if it goes off the grid
+    Move(StepDistance(elapsed_time));
+}
+
+/**
+ * @brief Moves the head by a distance in its current direction, wrapping around the grid boundaries.
+ * 
+ * @param distance Distance in units of 1/kPositionScale cells.
+ */
+void Snake::Move(std::int64_t distance) {
     switch (direction) {
         case Direction::kUp:
-            head_y -= speed * elapsed_time;
+            head_y = MoveWrapped(head_y, -distance, grid_height, kPositionScale);
             break;
         case Direction::kDown:
-            head_y += speed * elapsed_time;
+            head_y = MoveWrapped(head_y, distance, grid_height, kPositionScale);
             break;
         case Direction::kLeft:
-            head_x -= speed * elapsed_time;
+            head_x = MoveWrapped(head_x, -distance, grid_width, kPositionScale);
             break;
         case Direction::kRight:
-            head_x += speed * elapsed_time;
+            head_x = MoveWrapped(head_x, distance, grid_width, kPositionScale);
             break;
     }
-    // Wrap the snake around to the opposite side if it goes off the grid
-    head_x = fmod(head_x + grid_width, grid_width);
-    head_y = fmod(head_y + grid_height, grid_height);
+}
+
+/**
+ * @brief Returns the distance moved by one update, in units of 1/kPositionScale cells.
+ * 
+ * @param elapsed_time The time elapsed since the last update.
+ * @return std::int64_t Rounded distance.
+ */
+std::int64_t Snake::StepDistance(float elapsed_time) const {
+    return static_cast<std::int64_t>(std::round(speed * elapsed_time * kPositionScale));
+}
+
+/**
+ * @brief Returns how many updates of elapsed_time it takes until the head enters a new cell.
+ * 
+ * Works on the position in units of 1/kPositionScale cells, where all arithmetic is exact. Moving towards
+ * lower coordinates, the cell changes once the head drops below the cell's edge; moving towards higher
+ * coordinates, once it reaches the next cell's edge.
+ * 
+ * @param elapsed_time Duration of each update in seconds.
+ * @return std::uint64_t Number of updates, or UINT64_MAX if the snake does not move.
+ */
+std::uint64_t Snake::StepsUntilCellChange(float elapsed_time) const {
+    const std::int64_t distance = StepDistance(elapsed_time);
+    if (distance <= 0) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    const float position = (direction == Direction::kUp || direction == Direction::kDown) ? head_y : head_x;
+    const std::int64_t offset = static_cast<std::int64_t>((position - std::floor(position)) * kPositionScale);
+    if (direction == Direction::kUp || direction == Direction::kLeft) {
+        return static_cast<std::uint64_t>(offset / distance + 1);
+    }
+    const std::int64_t remaining = static_cast<std::int64_t>(kPositionScale) - offset;
+    return static_cast<std::uint64_t>((remaining + distance - 1) / distance);
+}
+
+/**
+ * @brief Applies a number of updates of elapsed_time at once, without entering a new cell.
+ * 
+ * @param steps Number of updates to apply; must be smaller than StepsUntilCellChange(elapsed_time).
+ * @param elapsed_time Duration of each update in seconds.
+ */
+void Snake::Advance(std::uint64_t steps, float elapsed_time) {
+    Move(static_cast<std::int64_t>(steps) * StepDistance(elapsed_time));
 }
 
 /**
@@ -74,6 +152,7 @@ void Snake::UpdateHead(float elapsed_time) {
 void Snake::UpdateBody(SDL_Point &current_head_cell, SDL_Point &prev_head_cell) {
   // Add previous head location to the beginning of the deque.
   body.push_front(prev_head_cell);
+  moves++;
 
   if (!growing) {
     // Remove the tail segment if not growing.
@@ -102,6 +181,7 @@ void Snake::Reset() {
   head_x = grid_width / 2;
   head_y = grid_height / 2;
   body.clear();
+  generation++;
   size = 1;
   alive = true;
   growing = false;
@@ -109,6 +189,37 @@ void Snake::Reset() {
   direction = Direction::kUp;
 }
 
+/**
+ * @brief Replaces the snake's whole state.
+ * 
+ * @param x Head x-coordinate.
+ * @param y Head y-coordinate.
+ * @param new_direction Movement direction.
+ * @param new_speed Speed in cells per second.
+ * @param grow Whether the snake grows on its next move.
+ * @param segments Body cells from the segment behind the head to the tail.
+ * @param length Number of body cells.
+ */
+void Snake::Adopt(float x, float y, Direction new_direction, float new_speed, bool grow, const SDL_Point *segments,
+                  std::size_t length) {
+  std::lock_guard<ProfiledMutex> lock(snake_mutex);
+  head_x = x;
+  head_y = y;
+  direction = new_direction;
+  speed = new_speed;
+  growing = grow;
+  body.assign(segments, segments + length);
+  generation++;
+  size = static_cast<int>(length) + 1;
+  alive = true;
+}
+
+/**
+ * @brief Returns whether the snake grows on its next move.
+ * @return true if GrowBody was called since the last move.
+ */
+bool Snake::IsGrowing() const { return growing; }
+
 /**
  * @brief Initiates the growth process of the snake, increasing its size after the next move.
  * 
@@ -116,7 +227,7 @@ void Snake::Reset() {
  * the size of the snake by one segment.
  */
 void Snake::GrowBody() {
-  std::lock_guard<std::mutex> lock(snake_mutex);
+  std::lock_guard<ProfiledMutex> lock(snake_mutex);
   growing = true;
 }
 
@@ -131,7 +242,7 @@ void Snake::GrowBody() {
  * @return true If the cell is occupied by the snake.
  * @return false If the cell is not occupied by the snake.
  */
-bool Snake::SnakeCell(int x, int y) {
+bool Snake::SnakeCell(int x, int y) const {
   for (auto const &item : body) {
     if (x == item.x && y == item.y) {
       return true;
@@ -148,3 +259,47 @@ bool Snake::SnakeCell(int x, int y) {
 void Snake::IncreaseSpeed() {
     speed *= 1.1;  // Increase speed by 10% of the current speed
 }
+
+/**
+ * @brief Makes this snake a copy of another one.
+ * 
+ * After k moves the source's first k segments are the cells the head left, followed by the body it had
+ * before, trimmed at the tail. While the generation matches, that is rebuilt from the previous copy in
+ * time linear in k.
+ * 
+ * @param source Snake to copy.
+ */
+void Snake::Mirror(const Snake &source) {
+  const std::uint64_t added = source.moves - moves;
+  if (source.generation == generation && source.moves >= moves && added <= source.body.size()) {
+    for (std::size_t i = static_cast<std::size_t>(added); i-- > 0;) {
+      body.push_front(source.body[i]);
+    }
+    body.resize(source.body.size());
+  } else {
+    body.assign(source.body.begin(), source.body.end());
+  }
+  moves = source.moves;
+  generation = source.generation;
+  direction = source.direction;
+  speed = source.speed;
+  size = source.size;
+  alive = source.alive;
+  head_x = source.head_x;
+  head_y = source.head_y;
+  growing = source.growing;
+  grid_width = source.grid_width;
+  grid_height = source.grid_height;
+}
+
+/**
+ * @brief Returns the width of the grid the snake moves on.
+ * @return int Grid width in cells.
+ */
+int Snake::GetGridWidth() const { return grid_width; }
+
+/**
+ * @brief Returns the height of the grid the snake moves on.
+ * @return int Grid height in cells.
+ */
+int Snake::GetGridHeight() const { return grid_height; }
@@ -2,12 +2,19 @@
 #define SNAKE_H
 
 #include "SDL.h"
+#include <cstdint>
 #include <deque>
 #include <mutex>
+#include "lockprofiler.h"
 
 /**
  * @brief Manages the behavior of the snake in the game, including movement, growth, and collision detection.
  * This class encapsulates all attributes and behaviors of the snake, such as its position, size, speed, and movement mechanics.
+ *
+ * The distance the head moves per update is rounded to a multiple of 1/kPositionScale of a cell, and the
+ * head is moved and wrapped in whole units of that size. Head coordinates then stay exactly representable
+ * as floats, so a number of identical updates can be applied at once with the same result as applying
+ * them one by one (see StepsUntilCellChange and Advance).
  */
 class Snake {
 public:
@@ -34,6 +41,27 @@ public:
    */
   void Update(float elapsed_time);
 
+  /**
+   * @brief Returns how many updates of elapsed_time it takes until the head enters a new cell.
+   * 
+   * Assumes direction and speed stay unchanged in the meantime.
+   * 
+   * @param elapsed_time Duration of each update in seconds.
+   * @return std::uint64_t Number of updates, the last of which changes the head's cell; UINT64_MAX if the snake does not move.
+   */
+  std::uint64_t StepsUntilCellChange(float elapsed_time) const;
+
+  /**
+   * @brief Applies a number of updates of elapsed_time at once, without entering a new cell.
+   * 
+   * Gives exactly the head position that calling Update that many times would. The caller must make sure
+   * the count is smaller than StepsUntilCellChange(elapsed_time), so that no cell change is skipped.
+   * 
+   * @param steps Number of updates to apply.
+   * @param elapsed_time Duration of each update in seconds.
+   */
+  void Advance(std::uint64_t steps, float elapsed_time);
+
   /**
    * @brief Increase the size of the snake by one segment.
    * This function is called when the snake eats food and needs to grow. It adjusts the snake's size and ensures
@@ -50,7 +78,7 @@ public:
    * @return true if the cell is occupied by the snake.
    * @return false otherwise.
    */
-  bool SnakeCell(int x, int y);
+  bool SnakeCell(int x, int y) const;
 
   /**
    * @brief Reset the snake to its initial state at the start of a new game.
@@ -58,12 +86,57 @@ public:
    */
   void Reset();
 
+  /**
+   * @brief Replace the snake's whole state, e.g. with one restored from a save file.
+   * 
+   * The body is copied in one bulk assignment; the size becomes the body length plus the head.
+   * 
+   * @param x Head x-coordinate.
+   * @param y Head y-coordinate.
+   * @param new_direction Movement direction.
+   * @param new_speed Speed in cells per second.
+   * @param grow Whether the snake grows on its next move.
+   * @param segments Body cells from the segment behind the head to the tail.
+   * @param length Number of body cells.
+   */
+  void Adopt(float x, float y, Direction new_direction, float new_speed, bool grow, const SDL_Point *segments,
+             std::size_t length);
+
+  /**
+   * @brief Makes this snake a copy of another one, e.g. to render it without holding the game lock.
+   * 
+   * If this snake was mirrored from the same source before and the source only moved since, just the cells
+   * the head left in the meantime are copied and the tail is trimmed; otherwise the whole body is copied.
+   * 
+   * @param source Snake to copy; must not change during the call.
+   */
+  void Mirror(const Snake &source);
+
+  /**
+   * @brief Returns whether the snake grows on its next move.
+   */
+  bool IsGrowing() const;
+
   /**
    * @brief Increase the speed of the snake.
    * This function increases the snake's speed, typically called when the snake consumes food to increase the game's difficulty.
    */
   void IncreaseSpeed();
 
+  /**
+   * @brief Retrieves the width of the grid the snake moves on.
+   * 
+   * @return int Grid width in cells.
+   */
+  int GetGridWidth() const;
+
+  /**
+   * @brief Retrieves the height of the grid the snake moves on.
+   * 
+   * @return int Grid height in cells.
+   */
+  int GetGridHeight() const;
+
   Direction direction = Direction::kUp; ///< Initial movement direction of the snake.
   float speed{10.0f}; ///< Speed of the snake, affects how quickly it moves across the grid.
   int size{1};        ///< Current size of the snake, increased by consuming food.
@@ -71,16 +144,30 @@ public:
   float head_x;       ///< x-coordinate of the snake's head.
   float head_y;       ///< y-coordinate of the snake's head.
   std::deque<SDL_Point> body; ///< Deque storing the positions of the snake's segments, used for rendering and collision detection.
+  std::uint64_t moves{0};      ///< Cells the head has entered; the body gained one segment at the front for each.
+  std::uint64_t generation{0}; ///< Incremented whenever the body is replaced instead of moved (Reset, Adopt).
+
+  ProfiledMutex snake_mutex{"Snake::snake_mutex"}; ///< Mutex to ensure thread-safe updates to the snake's state.
 
-  std::mutex snake_mutex; ///< Mutex to ensure thread-safe updates to the snake's state.
+  static constexpr float kPositionScale = 4096.0f; ///< Movement per update is a multiple of 1/kPositionScale cells.
 
 private:
+  /**
+   * @brief Returns the distance moved by one update, in units of 1/kPositionScale cells.
+   */
+  std::int64_t StepDistance(float elapsed_time) const;
+
   /**
    * @brief Update the position of the snake's head based on its direction and elapsed time.
    * Calculates the new position of the snake's head considering its current speed and the time elapsed to ensure smooth movement.
    */
   void UpdateHead(float elapsed_time);
 
+  /**
+   * @brief Moves the head by a distance in units of 1/kPositionScale cells in its direction, wrapping around the grid.
+   */
+  void Move(std::int64_t distance);
+
   /**
    * @brief Update the positions of the body segments following the head.
    * Adjusts the positions of the snake's body segments to follow the head, handling the mechanics of the snake's movement.
@@ -0,0 +1,346 @@
+#include "snakesprites.h"
+
+#ifdef SNAKE_HAVE_RENDER_GEOMETRY
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Sides of a cell as bits of a connection mask, in the order of Snake::Direction.
+ */
+enum Side { kSideUp = 1, kSideDown = 2, kSideLeft = 4, kSideRight = 8 };
+
+constexpr int kBand = 3; ///< Distance of the body's edges from the tile's edges, in atlas pixels.
+
+/**
+ * @brief Returns the side of a cell on which a neighbouring cell lies, counting wrapped grid edges, or 0.
+ */
+int SideTowards(const SDL_Point &from, const SDL_Point &to, int width, int height) {
+  const int dx = ((to.x - from.x) % width + width) % width;
+  const int dy = ((to.y - from.y) % height + height) % height;
+  if (dy == 0 && dx == 1) return kSideRight;
+  if (dy == 0 && dx == width - 1) return kSideLeft;
+  if (dx == 0 && dy == 1) return kSideDown;
+  if (dx == 0 && dy == height - 1) return kSideUp;
+  return 0;
+}
+
+/**
+ * @brief Returns the position of a single side bit in Snake::Direction order; up for anything else.
+ */
+int SideIndex(int side) {
+  switch (side) {
+    case kSideDown: return 1;
+    case kSideLeft: return 2;
+    case kSideRight: return 3;
+    default: return 0;
+  }
+}
+
+/**
+ * @brief Returns the side opposite to the one the snake is heading to.
+ */
+int BehindSide(Snake::Direction direction) {
+  switch (direction) {
+    case Snake::Direction::kUp: return kSideDown;
+    case Snake::Direction::kDown: return kSideUp;
+    case Snake::Direction::kLeft: return kSideRight;
+    case Snake::Direction::kRight: return kSideLeft;
+  }
+  return kSideDown;
+}
+
+/**
+ * @brief Returns true if a pixel belongs to a body tile with the given connections.
+ *
+ * Coordinates one pixel outside the tile are allowed; they count as covered where a connection continues
+ * into the neighbouring cell, so no outline is drawn across a connection.
+ */
+bool InBody(int mask, int x, int y, int size) {
+  const bool band_x = x >= kBand && x < size - kBand;
+  const bool band_y = y >= kBand && y < size - kBand;
+  return (band_x && band_y) || (band_x && y < kBand && (mask & kSideUp)) ||
+         (band_x && y >= size - kBand && (mask & kSideDown)) || (band_y && x < kBand && (mask & kSideLeft)) ||
+         (band_y && x >= size - kBand && (mask & kSideRight));
+}
+
+/**
+ * @brief Returns true if a pixel belongs to a head whose neck is on the upper side (v grows towards the snout).
+ */
+bool InHead(int u, int v, int size) {
+  if (v < 2) {
+    return u >= kBand && u < size - kBand;
+  }
+  if (u < 2 || u >= size - 2 || v >= size - 2) {
+    return false;
+  }
+  const float centre = (size - 1) / 2.0f;
+  const float radius = centre - 1.0f;
+  return v <= centre || (u - centre) * (u - centre) + (v - centre) * (v - centre) <= radius * radius;
+}
+
+/**
+ * @brief Returns true if a pixel is one of the eyes of a head whose neck is on the upper side.
+ */
+bool InEye(int u, int v, int size) {
+  const int row = size / 2 + 1;
+  return (v == row || v == row + 1) && (u == 4 || u == 5 || u == size - 6 || u == size - 5);
+}
+
+/**
+ * @brief Returns true if a pixel belongs to a tail that joins the body on the upper side and tapers off.
+ */
+bool InTail(int u, int v, int size) {
+  if (v >= size - kBand) {
+    return false;
+  }
+  const float centre = size / 2.0f;
+  const float half_width = centre - kBand - (v > 0 ? v * (centre - kBand - 1.0f) / (size - kBand) : 0.0f);
+  return std::abs(u + 0.5f - centre) <= half_width;
+}
+
+/**
+ * @brief Maps tile coordinates to those of a tile whose connection is on the upper side.
+ */
+void ToNeckUp(int side, int x, int y, int size, int &u, int &v) {
+  switch (side) {
+    case kSideDown: u = x; v = size - 1 - y; break;
+    case kSideLeft: u = y; v = x; break;
+    case kSideRight: u = y; v = size - 1 - x; break;
+    default: u = x; v = y; break;
+  }
+}
+
+} // namespace
+
+/**
+ * @brief Generates the sprite atlas and uploads it as a texture.
+ *
+ * If the texture cannot be created the error is logged and Ready() returns false.
+ *
+ * @param renderer Renderer the atlas is created for and drawn with.
+ */
+SnakeSprites::SnakeSprites(SDL_Renderer *renderer) : renderer(renderer), atlas(nullptr, SDL_DestroyTexture) {
+  BuildAtlas();
+}
+
+/**
+ * @brief Renders the tiles into an RGBA surface and creates the atlas texture from it.
+ *
+ * Tiles 0 to 15 are body segments indexed by their connection mask. Heads and tails follow, four each,
+ * indexed by the side on which they join the rest of the snake, in Snake::Direction order. Segments are
+ * drawn in light grey with a darker outline, so the vertex colour tints them; the head's eyes stay dark.
+ */
+void SnakeSprites::BuildAtlas() {
+  const int width = kAtlasColumns * kTileSize;
+  const int height = (kTileCount + kAtlasColumns - 1) / kAtlasColumns * kTileSize;
+  SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+  if (!surface) {
+    std::cerr << "Sprite atlas could not be created. SDL_Error: " << SDL_GetError() << "\n";
+    return;
+  }
+
+  for (int tile = 0; tile < kTileCount; ++tile) {
+    const int side = tile < kHeadTiles ? 0 : 1 << ((tile - kHeadTiles) % 4);
+    auto inside = [&](int x, int y) {
+      if (tile < kHeadTiles) {
+        return InBody(tile, x, y, kTileSize);
+      }
+      int u, v;
+      ToNeckUp(side, x, y, kTileSize, u, v);
+      return tile < kTailTiles ? InHead(u, v, kTileSize) : InTail(u, v, kTileSize);
+    };
+
+    for (int y = 0; y < kTileSize; ++y) {
+      Uint8 *row = static_cast<Uint8 *>(surface->pixels) +
+                   (tile / kAtlasColumns * kTileSize + y) * surface->pitch + tile % kAtlasColumns * kTileSize * 4;
+      for (int x = 0; x < kTileSize; ++x) {
+        Uint8 *pixel = row + x * 4;
+        if (!inside(x, y)) {
+          pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+          continue;
+        }
+        const bool outline = !inside(x - 1, y) || !inside(x + 1, y) || !inside(x, y - 1) || !inside(x, y + 1);
+        int u, v;
+        ToNeckUp(side, x, y, kTileSize, u, v);
+        const bool eye = tile >= kHeadTiles && tile < kTailTiles && InEye(u, v, kTileSize);
+        const Uint8 shade = eye ? 0x10 : outline ? 0x9A : 0xF0;
+        pixel[0] = pixel[1] = pixel[2] = shade;
+        pixel[3] = 0xFF;
+      }
+    }
+  }
+
+  atlas.reset(SDL_CreateTextureFromSurface(renderer, surface));
+  SDL_FreeSurface(surface);
+  if (!atlas) {
+    std::cerr << "Sprite atlas texture could not be created. SDL_Error: " << SDL_GetError() << "\n";
+    return;
+  }
+  SDL_SetTextureBlendMode(atlas.get(), SDL_BLENDMODE_BLEND);
+}
+
+/**
+ * @brief Reallocates the ring for at least the given number of segments and fills the index buffer.
+ *
+ * A quarter of the segments is added as headroom, so a growing snake causes only a logarithmic number of
+ * rebuilds while the buffers stay within a constant factor of the snake, up to kMaxSegments.
+ *
+ * @param segments Number of segments the ring must hold.
+ */
+void SnakeSprites::Reserve(std::size_t segments) {
+  slots = std::min(std::max<std::size_t>(segments + segments / 4, 64), std::max(segments, kMaxSegments));
+  vertices.assign(slots * 4, SDL_Vertex{});
+  indices.resize(slots * 6);
+  for (std::size_t k = 0; k < slots; ++k) {
+    const int base = static_cast<int>(k * 4);
+    int *quad = &indices[k * 6];
+    quad[0] = base;
+    quad[1] = base + 1;
+    quad[2] = base + 2;
+    quad[3] = base + 2;
+    quad[4] = base + 1;
+    quad[5] = base + 3;
+  }
+}
+
+/**
+ * @brief Rewrites every quad of the snake, starting from slot 0.
+ *
+ * @param snake Snake to draw.
+ * @param workers Pool the rewrite is split across.
+ */
+void SnakeSprites::Rebuild(const Snake &snake, RenderWorkers &workers) {
+  count = snake.body.size() + 1;
+  if (count > slots) {
+    Reserve(count);
+  }
+  front = 0;
+  WriteSegments(snake, 0, count, workers);
+}
+
+/**
+ * @brief Rewrites the quads of a range of segments.
+ *
+ * Each segment only reads the snake and writes its own slot, so chunks can be written in any order.
+ *
+ * @param snake Snake to draw.
+ * @param first First segment to rewrite.
+ * @param last One past the last segment to rewrite.
+ * @param workers Pool the rewrite is split across.
+ */
+void SnakeSprites::WriteSegments(const Snake &snake, std::size_t first, std::size_t last, RenderWorkers &workers) {
+  workers.ForEachChunk(last - first, [&](std::size_t, std::size_t begin, std::size_t end) {
+    for (std::size_t i = first + begin; i < first + end; ++i) {
+      WriteSegment(snake, i);
+    }
+  });
+}
+
+/**
+ * @brief Rewrites the quad of one segment: its position, its tile and its tint.
+ *
+ * A body segment's tile depends on the sides its two neighbours are on, the head's and the tail's on the
+ * side of their single neighbour. A head without a body faces the direction the snake is heading.
+ *
+ * @param snake Snake to draw.
+ * @param index Segment to rewrite: 0 is the head, i > 0 is body[i - 1].
+ */
+void SnakeSprites::WriteSegment(const Snake &snake, std::size_t index) {
+  const int grid_width = snake.GetGridWidth();
+  const int grid_height = snake.GetGridHeight();
+  const SDL_Point head_cell{static_cast<int>(snake.head_x), static_cast<int>(snake.head_y)};
+  const SDL_Point cell = index == 0 ? head_cell : snake.body[index - 1];
+
+  int tile;
+  SDL_Color color{0xFF, 0xFF, 0xFF, 0xFF};
+  if (index == 0) {
+    const int neck = snake.body.empty() ? BehindSide(snake.direction)
+                                        : SideTowards(cell, snake.body.front(), grid_width, grid_height);
+    tile = kHeadTiles + SideIndex(neck);
+    color = snake.alive ? SDL_Color{0x00, 0x7A, 0xCC, 0xFF} : SDL_Color{0xFF, 0x00, 0x00, 0xFF};
+  } else {
+    const SDL_Point &towards_head = index == 1 ? head_cell : snake.body[index - 2];
+    const int head_side = SideTowards(cell, towards_head, grid_width, grid_height);
+    if (index == count - 1) {
+      tile = kTailTiles + SideIndex(head_side);
+    } else {
+      tile = head_side | SideTowards(cell, snake.body[index], grid_width, grid_height);
+    }
+  }
+
+  const float atlas_width = static_cast<float>(kAtlasColumns * kTileSize);
+  const float atlas_height = static_cast<float>((kTileCount + kAtlasColumns - 1) / kAtlasColumns * kTileSize);
+  const float u0 = (tile % kAtlasColumns * kTileSize + 0.5f) / atlas_width;
+  const float u1 = ((tile % kAtlasColumns + 1) * kTileSize - 0.5f) / atlas_width;
+  const float v0 = (tile / kAtlasColumns * kTileSize + 0.5f) / atlas_height;
+  const float v1 = ((tile / kAtlasColumns + 1) * kTileSize - 0.5f) / atlas_height;
+  const float x0 = static_cast<float>(cell.x * cell_width);
+  const float y0 = static_cast<float>(cell.y * cell_height);
+  const float x1 = x0 + cell_width;
+  const float y1 = y0 + cell_height;
+
+  SDL_Vertex *quad = &vertices[(front + index) % slots * 4];
+  quad[0] = SDL_Vertex{{x0, y0}, color, {u0, v0}};
+  quad[1] = SDL_Vertex{{x1, y0}, color, {u1, v0}};
+  quad[2] = SDL_Vertex{{x0, y1}, color, {u0, v1}};
+  quad[3] = SDL_Vertex{{x1, y1}, color, {u1, v1}};
+}
+
+/**
+ * @brief Brings the vertex buffer up to date with the snake and draws it.
+ *
+ * Snake::moves tells how many segments were added at the front since the last frame. The ring's front moves
+ * back by that many slots, which keeps every retained segment in its slot; the new cells, the former head
+ * and the new tail are rewritten, and the head is rewritten every frame for its tint. If the count does not
+ * add up, or the former head is not where the new body says it is, the ring is rebuilt from scratch. The
+ * segments up to the end of the ring are drawn first, then those that wrapped to its start.
+ *
+ * @param snake Snake to draw.
+ * @param cell_width Width of a grid cell in pixels.
+ * @param cell_height Height of a grid cell in pixels.
+ * @param workers Pool that rewrites large numbers of quads in parallel.
+ * @return false if SDL_RenderGeometry failed, e.g. because the renderer does not support it.
+ */
+bool SnakeSprites::Draw(const Snake &snake, int cell_width, int cell_height, RenderWorkers &workers) {
+  const SDL_Point head_cell{static_cast<int>(snake.head_x), static_cast<int>(snake.head_y)};
+  const std::size_t segments = snake.body.size() + 1;
+  const std::uint64_t added = snake.moves - moves;
+
+  bool incremental = valid && snake.generation == generation && cell_width == this->cell_width &&
+                     cell_height == this->cell_height && segments <= slots && added < segments &&
+                     segments - added <= count;
+  if (incremental) {
+    const SDL_Point &former_head = added == 0 ? head_cell : snake.body[added - 1];
+    incremental = former_head.x == head.x && former_head.y == head.y;
+  }
+
+  this->cell_width = cell_width;
+  this->cell_height = cell_height;
+  if (incremental) {
+    front = (front + slots - added) % slots;
+    count = segments;
+    WriteSegments(snake, 0, added + 1, workers);
+    WriteSegment(snake, count - 1);
+  } else {
+    Rebuild(snake, workers);
+  }
+  moves = snake.moves;
+  generation = snake.generation;
+  head = head_cell;
+  valid = true;
+
+  const std::size_t first_part = std::min(count, slots - front);
+  if (SDL_RenderGeometry(renderer, atlas.get(), vertices.data(), static_cast<int>(slots * 4),
+                         indices.data() + front * 6, static_cast<int>(first_part * 6)) != 0) {
+    return false;
+  }
+  return count == first_part ||
+         SDL_RenderGeometry(renderer, atlas.get(), vertices.data(), static_cast<int>(slots * 4), indices.data(),
+                            static_cast<int>((count - first_part) * 6)) == 0;
+}
+
+#endif // SNAKE_HAVE_RENDER_GEOMETRY
@@ -0,0 +1,119 @@
+#ifndef SNAKE_SPRITES_H
+#define SNAKE_SPRITES_H
+
+#include "SDL.h"
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define SNAKE_HAVE_RENDER_GEOMETRY 1
+#endif
+
+#ifdef SNAKE_HAVE_RENDER_GEOMETRY
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "renderworkers.h"
+#include "snake.h"
+
+/**
+ * @brief Draws the snake with textured segment sprites in a single SDL_RenderGeometry call.
+ *
+ * All sprites live in one atlas texture that is generated when the object is constructed: a body tile
+ * for each combination of connected sides, and a head and a tail tile for each direction. The snake is
+ * kept as one textured quad per segment in a ring of quad slots, with the head in the front slot. When the
+ * snake wraps past the end of the ring, the part from the start of the ring is drawn with a second call.
+ *
+ * Between frames only what changed is rewritten: the cells the head entered, the segment that used to be
+ * the head, and the new tail. The rest of the quads stay valid because the snake only gains segments at
+ * the front and loses them at the back. The whole ring is rebuilt when the body was replaced, the cell size
+ * changed or the snake outgrew the ring. Every quad has a fixed slot, so large rewrites are split across
+ * the render workers without any merging afterwards.
+ *
+ * Requires SDL 2.0.18 or later; with older versions the renderer keeps drawing filled rectangles.
+ */
+class SnakeSprites {
+public:
+  static constexpr std::size_t kMaxSegments = std::size_t{1} << 20; ///< Longest snake drawn with sprites, head included.
+
+  /**
+   * @brief Generates the sprite atlas and uploads it as a texture.
+   *
+   * @param renderer Renderer the atlas is created for and drawn with.
+   */
+  explicit SnakeSprites(SDL_Renderer *renderer);
+
+  SnakeSprites(const SnakeSprites &) = delete;
+  SnakeSprites &operator=(const SnakeSprites &) = delete;
+
+  /**
+   * @brief Returns true if the atlas texture could be created.
+   */
+  bool Ready() const { return atlas != nullptr; }
+
+  /**
+   * @brief Brings the vertex buffer up to date with the snake and draws it.
+   *
+   * @param snake Snake to draw.
+   * @param cell_width Width of a grid cell in pixels.
+   * @param cell_height Height of a grid cell in pixels.
+   * @param workers Pool that rewrites large numbers of quads in parallel.
+   * @return false if SDL_RenderGeometry is not supported by the renderer; nothing was drawn then. The snake
+   *         must have at most kMaxSegments segments.
+   */
+  bool Draw(const Snake &snake, int cell_width, int cell_height, RenderWorkers &workers);
+
+private:
+  static constexpr int kTileSize = 16;     ///< Width and height of a tile in the atlas, in pixels.
+  static constexpr int kAtlasColumns = 8;  ///< Tiles per atlas row.
+  static constexpr int kHeadTiles = 16;    ///< First head tile; tiles before it are bodies by connection mask.
+  static constexpr int kTailTiles = 20;    ///< First tail tile.
+  static constexpr int kTileCount = 24;    ///< Tiles in the atlas.
+
+  /**
+   * @brief Renders the tiles into an RGBA surface and creates the atlas texture from it.
+   */
+  void BuildAtlas();
+
+  /**
+   * @brief Reallocates the ring for at least the given number of segments and fills the index buffer.
+   */
+  void Reserve(std::size_t segments);
+
+  /**
+   * @brief Rewrites every quad of the snake.
+   */
+  void Rebuild(const Snake &snake, RenderWorkers &workers);
+
+  /**
+   * @brief Rewrites the quads of segments first to last - 1, split across the workers if there are many.
+   */
+  void WriteSegments(const Snake &snake, std::size_t first, std::size_t last, RenderWorkers &workers);
+
+  /**
+   * @brief Rewrites the quad of one segment.
+   *
+   * @param snake Snake to draw.
+   * @param index Segment to rewrite: 0 is the head, i > 0 is body[i - 1].
+   */
+  void WriteSegment(const Snake &snake, std::size_t index);
+
+  SDL_Renderer *renderer; ///< Renderer the atlas belongs to.
+  std::unique_ptr<SDL_Texture, void(*)(SDL_Texture*)> atlas; ///< Texture holding every tile.
+
+  std::vector<SDL_Vertex> vertices; ///< Four vertices per ring slot.
+  std::vector<int> indices;         ///< Six indices per slot.
+  std::size_t slots{0};             ///< Capacity of the ring in segments.
+  std::size_t front{0};             ///< Slot holding the head.
+  std::size_t count{0};             ///< Segments in the ring, head included.
+
+  std::uint64_t moves{0};       ///< Snake::moves when the ring was last updated.
+  std::uint64_t generation{0};  ///< Snake::generation when the ring was last updated.
+  SDL_Point head{0, 0};         ///< Head cell when the ring was last updated.
+  int cell_width{0};            ///< Cell size the quads were built for.
+  int cell_height{0};
+  bool valid{false};            ///< Whether the ring holds a snake at all.
+};
+
+#endif // SNAKE_HAVE_RENDER_GEOMETRY
+
+#endif // SNAKE_SPRITES_H
@@ -0,0 +1,154 @@
+#include "soakmonitor.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include "metrics.h"
+
+namespace {
+
+/**
+ * @brief A metric whose trend is checked, with the noise floor its growth must exceed to count.
+ */
+struct Series {
+  const char *name;
+  double noise_floor;
+  std::vector<double> values;
+};
+
+/**
+ * @brief Fits a least-squares line and returns its slope.
+ */
+double Slope(const std::vector<double> &x, const std::vector<double> &y) {
+  const double n = static_cast<double>(x.size());
+  double mean_x = 0.0;
+  double mean_y = 0.0;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    mean_x += x[i] / n;
+    mean_y += y[i] / n;
+  }
+  double covariance = 0.0;
+  double variance = 0.0;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    covariance += (x[i] - mean_x) * (y[i] - mean_y);
+    variance += (x[i] - mean_x) * (x[i] - mean_x);
+  }
+  return variance > 0.0 ? covariance / variance : 0.0;
+}
+
+} // namespace
+
+/**
+ * @brief Construct a new SoakMonitor and take the baseline snapshot of the histograms.
+ *
+ * @param config Duration, sampling interval and growth threshold of the run.
+ */
+SoakMonitor::SoakMonitor(const SoakConfig &config)
+    : config(config),
+      start(Clock::now()),
+      next_sample(start + config.interval),
+      last_frames(Metrics::Instance().frame_time_us.Read()),
+      last_jitter(Metrics::Instance().tick_jitter_us.Read()) {}
+
+/**
+ * @brief Takes a sample if the sampling interval has elapsed and logs it.
+ *
+ * Percentiles cover only the values recorded since the previous sample, so a slow drift is not
+ * hidden by the history accumulated in the histograms.
+ */
+void SoakMonitor::SampleDue() {
+  Clock::time_point now = Clock::now();
+  if (now < next_sample) {
+    return;
+  }
+  next_sample += config.interval;
+
+  Metrics &metrics = Metrics::Instance();
+  Histogram::Snapshot frames = metrics.frame_time_us.Read();
+  Histogram::Snapshot jitter = metrics.tick_jitter_us.Read();
+  Histogram::Snapshot frame_interval = frames.Since(last_frames);
+  Histogram::Snapshot jitter_interval = jitter.Since(last_jitter);
+  last_frames = frames;
+  last_jitter = jitter;
+
+  Sample sample{std::chrono::duration<double>(now - start).count(),
+                ProcessStats::Read(),
+                frame_interval.Percentile(50) / 1000.0,
+                frame_interval.Percentile(99) / 1000.0,
+                jitter_interval.Percentile(99) / 1000.0,
+                metrics.games_total.load(std::memory_order_relaxed)};
+  samples.push_back(sample);
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "soak t=" << sample.elapsed_s << "s rss=" << sample.process.rss_bytes / 1048576.0 << "MB"
+            << " fds=" << sample.process.open_fds << " threads=" << sample.process.threads
+            << " frame p50/p99=" << sample.frame_p50_ms << "/" << sample.frame_p99_ms << "ms"
+            << " jitter p99=" << sample.jitter_p99_ms << "ms games=" << sample.games << "\n";
+}
+
+/**
+ * @brief Returns true once the configured duration has elapsed.
+ */
+bool SoakMonitor::Finished() const {
+  return Clock::now() - start >= config.duration;
+}
+
+/**
+ * @brief Prints the trend of every metric and returns whether the run passed.
+ *
+ * The first 10% of the samples (at least one) are skipped as warm-up, since caches, allocator pools
+ * and the first game's threads legitimately grow at start-up. Growth is the rise of the fitted line
+ * over the rest of the run, relative to the fitted starting value (or the noise floor, if larger).
+ */
+bool SoakMonitor::Evaluate(std::ostream &out) const {
+  std::size_t warm_up = std::max<std::size_t>(1, samples.size() / 10);
+  if (samples.size() < warm_up + 3) {
+    out << "Soak: only " << samples.size() << " samples, not enough to detect a trend\n";
+    return true;
+  }
+
+  std::vector<double> times;
+  std::vector<Series> series = {{"rss (MB)", 4.0, {}},
+                                {"open fds", 2.0, {}},
+                                {"threads", 2.0, {}},
+                                {"frame p99 (ms)", 2.0, {}},
+                                {"jitter p99 (ms)", 2.0, {}}};
+  for (std::size_t i = warm_up; i < samples.size(); ++i) {
+    const Sample &sample = samples[i];
+    times.push_back(sample.elapsed_s);
+    series[0].values.push_back(sample.process.rss_bytes / 1048576.0);
+    series[1].values.push_back(sample.process.open_fds);
+    series[2].values.push_back(sample.process.threads);
+    series[3].values.push_back(sample.frame_p99_ms);
+    series[4].values.push_back(sample.jitter_p99_ms);
+  }
+
+  const double span = times.back() - times.front();
+  bool passed = true;
+  out << "Soak trend over " << std::fixed << std::setprecision(0) << span << "s (threshold "
+      << config.threshold_percent << "%):\n";
+  out << std::left << std::setw(18) << "metric" << std::right << std::setw(10) << "start"
+      << std::setw(10) << "end" << std::setw(10) << "growth" << "\n";
+  out << std::setprecision(2);
+  for (const Series &entry : series) {
+    double slope = Slope(times, entry.values);
+    double mean = 0.0;
+    for (double value : entry.values) {
+      mean += value / entry.values.size();
+    }
+    double mean_time = 0.0;
+    for (double time : times) {
+      mean_time += time / times.size();
+    }
+    double fitted_start = mean + slope * (times.front() - mean_time);
+    double growth = slope * span;
+    double percent = 100.0 * growth / std::max(fitted_start, entry.noise_floor);
+    bool drifting = growth > entry.noise_floor && percent > config.threshold_percent;
+    passed = passed && !drifting;
+
+    out << std::left << std::setw(18) << entry.name << std::right << std::setw(10) << fitted_start
+        << std::setw(10) << fitted_start + growth << std::setw(9) << percent << "%"
+        << (drifting ? "  DRIFT" : "") << "\n";
+  }
+  out << (passed ? "Soak passed\n" : "Soak FAILED: metrics trend upward beyond the threshold\n");
+  return passed;
+}
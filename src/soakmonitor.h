@@ -0,0 +1,77 @@
+#ifndef SOAK_MONITOR_H
+#define SOAK_MONITOR_H
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+#include "histogram.h"
+#include "processstats.h"
+
+/**
+ * @brief Settings of a soak run.
+ */
+struct SoakConfig {
+  std::chrono::seconds duration{3600};   ///< Total length of the run.
+  std::chrono::seconds interval{10};     ///< Time between two samples.
+  double threshold_percent{10.0};        ///< Allowed growth of any metric over the run.
+};
+
+/**
+ * @brief Samples resource usage and timing during a soak run and detects upward drift.
+ *
+ * At every interval the monitor records RSS, open file descriptors, thread count, and frame time and
+ * tick jitter percentiles of that interval (taken from Metrics). At the end, a least-squares line is
+ * fitted through each series; the run fails if the growth it predicts over the run exceeds the
+ * threshold relative to the starting value and a small absolute noise floor.
+ */
+class SoakMonitor {
+public:
+  /**
+   * @brief Construct a new SoakMonitor and take the baseline snapshot of the histograms.
+   *
+   * @param config Duration, sampling interval and growth threshold of the run.
+   */
+  explicit SoakMonitor(const SoakConfig &config);
+
+  /**
+   * @brief Takes a sample if the sampling interval has elapsed. Called from the main loop.
+   */
+  void SampleDue();
+
+  /**
+   * @brief Returns true once the configured duration has elapsed.
+   */
+  bool Finished() const;
+
+  /**
+   * @brief Prints the trend of every metric and returns whether the run passed.
+   *
+   * @param out Stream to print to.
+   * @return true if no metric grew beyond the threshold.
+   */
+  bool Evaluate(std::ostream &out) const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief One set of measurements.
+   */
+  struct Sample {
+    double elapsed_s;       ///< Seconds since the start of the run.
+    ProcessStats process;   ///< Resource usage at sampling time.
+    double frame_p50_ms;    ///< Median frame time during the interval.
+    double frame_p99_ms;    ///< 99th percentile frame time during the interval.
+    double jitter_p99_ms;   ///< 99th percentile tick jitter during the interval.
+    std::uint64_t games;    ///< Games started so far.
+  };
+
+  const SoakConfig config;             ///< Settings of the run.
+  const Clock::time_point start;       ///< Start of the run.
+  Clock::time_point next_sample;       ///< Time of the next sample.
+  Histogram::Snapshot last_frames;     ///< Frame time histogram at the previous sample.
+  Histogram::Snapshot last_jitter;     ///< Tick jitter histogram at the previous sample.
+  std::vector<Sample> samples;         ///< Samples taken so far.
+};
+
+#endif // SOAK_MONITOR_H
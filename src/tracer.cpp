@@ -0,0 +1,142 @@
+#include "tracer.h"
+
+#ifdef SNAKE_ENABLE_TRACING
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * @brief Returns the process-wide tracer, creating it on first use.
+ */
+Tracer &Tracer::Instance() {
+  static Tracer tracer;
+  return tracer;
+}
+
+/**
+ * @brief Constructs the tracer and fixes the time origin of the trace.
+ */
+Tracer::Tracer() : origin(std::chrono::steady_clock::now()) {}
+
+/**
+ * @brief Returns the current time relative to the tracer origin, in nanoseconds.
+ */
+std::int64_t Tracer::Now() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+/**
+ * @brief Returns the calling thread's buffer, creating it on first use.
+ *
+ * Every thread gets a buffer and a lane of its own, also when it replaces a thread of the same name that
+ * has exited. Only the first call on each thread takes the registry lock; later calls hit the
+ * thread-local cache.
+ */
+Tracer::ThreadBuffer &Tracer::LocalBuffer() {
+  thread_local ThreadBuffer *buffer = nullptr;
+  if (!buffer) {
+    std::lock_guard<std::mutex> lock(registry_mtx);
+    buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<int>(buffers.size()) + 1));
+    buffer = buffers.back().get();
+  }
+  return *buffer;
+}
+
+/**
+ * @brief Appends an event to the calling thread's buffer without locking.
+ *
+ * The event is written before the count is published, so a reader that loads the count with acquire
+ * semantics only ever sees fully written events, in blocks that were allocated before.
+ */
+void Tracer::Record(const char *name, std::int64_t start_ns, std::int64_t end_ns) {
+  ThreadBuffer &buffer = LocalBuffer();
+  std::size_t index = buffer.count.load(std::memory_order_relaxed);
+  if (index >= kEventsPerThread) {
+    if (buffer.dropped.fetch_add(1, std::memory_order_relaxed) == 0) {
+      std::lock_guard<std::mutex> lock(registry_mtx);
+      std::cerr << "Trace buffer of thread " << (buffer.name ? buffer.name : "thread") << " (lane " << buffer.tid
+                << ") is full after " << kEventsPerThread << " events; later events of this thread are dropped\n";
+    }
+    return;
+  }
+  std::unique_ptr<Event[]> &block = buffer.blocks[index / kEventsPerBlock];
+  if (!block) {
+    block.reset(new Event[kEventsPerBlock]);
+  }
+  block[index % kEventsPerBlock] = Event{name, start_ns, end_ns};
+  buffer.count.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Names the calling thread's lane in the trace viewer.
+ */
+void Tracer::SetThreadName(const char *name) {
+  ThreadBuffer &buffer = LocalBuffer();
+  std::lock_guard<std::mutex> lock(registry_mtx);
+  buffer.name = name;
+}
+
+/**
+ * @brief Returns the trace output path, taken from SNAKE_TRACE_FILE or "snake_trace.json" by default.
+ */
+std::string Tracer::OutputPath() {
+  const char *path = std::getenv("SNAKE_TRACE_FILE");
+  return path ? path : "snake_trace.json";
+}
+
+/**
+ * @brief Writes every recorded event in the Chrome trace-event JSON format.
+ *
+ * Each thread becomes one lane, named through a "thread_name" metadata event. Timestamps and
+ * durations are written in microseconds as the format requires.
+ *
+ * @param path Output file path.
+ * @return true if the file was written.
+ */
+bool Tracer::Flush(const std::string &path) {
+  std::ofstream out(path);
+  if (!out) {
+    std::cerr << "Trace file could not be opened: " << path << "\n";
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(registry_mtx);
+  std::size_t total = 0;
+  bool first = true;
+  auto separator = [&]() -> std::ostream & {
+    if (!first) out << ",\n";
+    first = false;
+    return out;
+  };
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" << std::fixed << std::setprecision(3);
+  for (const auto &buffer : buffers) {
+    separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"args\":{\"name\":\"" << (buffer->name ? buffer->name : "thread") << "\"}}";
+  }
+  for (const auto &buffer : buffers) {
+    std::size_t count = buffer->count.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+      const Event &event = buffer->blocks[i / kEventsPerBlock][i % kEventsPerBlock];
+      separator() << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                  << ",\"ts\":" << event.start_ns / 1000.0
+                  << ",\"dur\":" << (event.end_ns - event.start_ns) / 1000.0 << "}";
+    }
+    total += count;
+  }
+  out << "\n]}\n";
+
+  std::cout << "Trace written to " << path << " (" << total << " events)\n";
+  for (const auto &buffer : buffers) {
+    std::size_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+      std::cout << "  " << dropped << " events of thread " << (buffer->name ? buffer->name : "thread") << " (lane "
+                << buffer->tid << ") dropped\n";
+    }
+  }
+  return static_cast<bool>(out);
+}
+
+#endif // SNAKE_ENABLE_TRACING
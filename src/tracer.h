@@ -0,0 +1,143 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+/**
+ * @file tracer.h
+ * @brief Scoped trace markers exported as Chrome/Perfetto trace-event JSON.
+ *
+ * Tracing is compiled in only when SNAKE_ENABLE_TRACING is defined (CMake option of the same name).
+ * Without it, the TRACE_* macros expand to nothing and none of the classes below exist.
+ */
+
+#ifdef SNAKE_ENABLE_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Collects complete ("X") trace events into per-thread buffers and writes them out as JSON.
+ *
+ * Each thread records into its own buffer, so recording never takes a lock. A buffer is registered the
+ * first time a thread records an event and becomes one lane of the trace. Threads restarted on every
+ * game (e.g. snakeThread) get a new buffer each time, with the full capacity and a drop count of their
+ * own. Buffer memory is allocated in blocks as events arrive, so a short-lived thread costs little.
+ */
+class Tracer {
+public:
+  /**
+   * @brief A single completed scope.
+   */
+  struct Event {
+    const char *name;     ///< Static string naming the scope.
+    std::int64_t start_ns; ///< Start time relative to the tracer origin, in nanoseconds.
+    std::int64_t end_ns;   ///< End time relative to the tracer origin, in nanoseconds.
+  };
+
+  /**
+   * @brief Returns the process-wide tracer.
+   */
+  static Tracer &Instance();
+
+  /**
+   * @brief Returns the current time relative to the tracer origin, in nanoseconds.
+   */
+  std::int64_t Now() const;
+
+  /**
+   * @brief Appends an event to the calling thread's buffer, dropping it if the buffer is full.
+   *
+   * The first dropped event of each thread is reported on stderr, so a truncated trace is noticed while
+   * the game is still running.
+   *
+   * @param name Static string naming the scope; only the pointer is stored.
+   * @param start_ns Start time as returned by Now().
+   * @param end_ns End time as returned by Now().
+   */
+  void Record(const char *name, std::int64_t start_ns, std::int64_t end_ns);
+
+  /**
+   * @brief Names the calling thread's lane in the trace viewer.
+   *
+   * @param name Static string naming the thread.
+   */
+  void SetThreadName(const char *name);
+
+  /**
+   * @brief Writes all recorded events as trace-event JSON.
+   *
+   * Must be called once the traced threads have been joined; events are read without synchronising
+   * with writers that are still running.
+   *
+   * @param path Output file path.
+   * @return true if the file was written.
+   */
+  bool Flush(const std::string &path);
+
+  /**
+   * @brief Returns the trace output path, taken from SNAKE_TRACE_FILE or "snake_trace.json" by default.
+   */
+  static std::string OutputPath();
+
+private:
+  static constexpr std::size_t kEventsPerThread = 1 << 15; ///< Capacity of each thread buffer.
+  static constexpr std::size_t kEventsPerBlock = 1 << 10;  ///< Events allocated at once.
+  static constexpr std::size_t kBlocks = kEventsPerThread / kEventsPerBlock;
+
+  /**
+   * @brief Single-writer event buffer of one thread.
+   */
+  struct ThreadBuffer {
+    explicit ThreadBuffer(int tid) : tid(tid) {}
+
+    const int tid;                            ///< Lane of the thread in the trace.
+    const char *name{nullptr};                ///< Name of the lane, guarded by registry_mtx; nullptr if unnamed.
+    std::unique_ptr<Event[]> blocks[kBlocks]; ///< Event storage, allocated block by block by the writer.
+    std::atomic<std::size_t> count{0};        ///< Number of valid events, published with release.
+    std::atomic<std::size_t> dropped{0};      ///< Events lost because the buffer was full.
+  };
+
+  Tracer();
+
+  ThreadBuffer &LocalBuffer();
+
+  const std::chrono::steady_clock::time_point origin; ///< Time zero of the trace.
+  std::mutex registry_mtx;                             ///< Guards buffers and the lane names.
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;  ///< One buffer per traced thread, in order of creation.
+};
+
+/**
+ * @brief Records the lifetime of the enclosing scope as one trace event.
+ */
+class TraceScope {
+public:
+  explicit TraceScope(const char *name) : name(name), start_ns(Tracer::Instance().Now()) {}
+  ~TraceScope() { Tracer::Instance().Record(name, start_ns, Tracer::Instance().Now()); }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+  const char *name;
+  std::int64_t start_ns;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) Tracer::Instance().SetThreadName(name)
+#define TRACE_FLUSH() Tracer::Instance().Flush(Tracer::OutputPath())
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#define TRACE_FLUSH() ((void)0)
+
+#endif // SNAKE_ENABLE_TRACING
+
+#endif // TRACER_H
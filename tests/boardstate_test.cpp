@@ -0,0 +1,171 @@
+#include <sstream>
+#include <string>
+#include "check.h"
+#include "boardstate.h"
+
+namespace {
+
+/**
+ * @brief A straight snake of three cells heading up on a 10x10 grid, with food on a free cell.
+ */
+BoardState SampleBoard() {
+  BoardState state;
+  state.grid_width = 10;
+  state.grid_height = 10;
+  state.head_x = 5.0f;
+  state.head_y = 5.0f;
+  state.body = {{5, 6}, {5, 7}};
+  state.direction = Snake::Direction::kUp;
+  state.food = {1, 1};
+  return state;
+}
+
+/**
+ * @brief Returns the error ValidateBoard gives for a state, or "" if it is valid.
+ */
+std::string ValidationError(const BoardState &state) {
+  std::string error;
+  return ValidateBoard(state, error) ? std::string() : error;
+}
+
+/**
+ * @brief Returns the error ParseBoardText gives for a text, or "" if it parses.
+ */
+std::string ParseError(const std::string &text) {
+  std::istringstream in(text);
+  BoardState state;
+  std::string error;
+  return ParseBoardText(in, state, error) ? std::string() : error;
+}
+
+/**
+ * @brief Each rule of ValidateBoard rejects the state that breaks it, and nothing else.
+ */
+void TestValidate() {
+  CHECK_EQ(ValidationError(SampleBoard()), std::string());
+
+  BoardState state = SampleBoard();
+  state.grid_width = 0;
+  CHECK_EQ(ValidationError(state), std::string("grid must not be empty"));
+
+  state = SampleBoard();
+  state.grid_height = kMaxGridSide + 1;
+  CHECK_EQ(ValidationError(state), "grid is larger than " + std::to_string(kMaxGridSide) + " cells per side");
+
+  state = SampleBoard();
+  state.head_x = 10.0f;
+  CHECK_EQ(ValidationError(state), std::string("head is off the grid"));
+
+  state = SampleBoard();
+  state.speed = 0.0f;
+  CHECK_EQ(ValidationError(state), std::string("speed must be positive"));
+
+  state = SampleBoard();
+  state.score = -1;
+  CHECK_EQ(ValidationError(state), std::string("score must not be negative"));
+
+  state = SampleBoard();
+  state.body = {{5, 6}, {5, 8}};
+  CHECK_EQ(ValidationError(state), std::string("body cell 1 is not next to the previous one"));
+
+  state = SampleBoard();
+  state.body = {{5, 6}, {5, 5}};
+  CHECK_EQ(ValidationError(state), std::string("body cell 1 overlaps the snake"));
+
+  state = SampleBoard();
+  state.body = {{5, 6}, {5, 10}};
+  CHECK_EQ(ValidationError(state), std::string("body cell 1 is off the grid"));
+
+  state = SampleBoard();
+  state.direction = Snake::Direction::kDown;
+  CHECK_EQ(ValidationError(state), std::string("snake is heading into its own body"));
+
+  state = SampleBoard();
+  state.food = {5, 7};
+  CHECK_EQ(ValidationError(state), std::string("food is on the snake"));
+
+  state = SampleBoard();
+  state.food = {-1, 0};
+  CHECK_EQ(ValidationError(state), std::string("food is off the grid"));
+
+  // Neighbours across the grid edge are adjacent
+  state = SampleBoard();
+  state.head_x = 0.5f;
+  state.body = {{9, 5}, {8, 5}};
+  state.direction = Snake::Direction::kRight;
+  CHECK_EQ(ValidationError(state), std::string());
+
+  // A snake covering every cell leaves no room for the food
+  state = SampleBoard();
+  state.grid_width = 2;
+  state.grid_height = 2;
+  state.head_x = 0.0f;
+  state.head_y = 0.0f;
+  state.body = {{1, 0}, {1, 1}, {0, 1}};
+  state.direction = Snake::Direction::kDown;
+  state.food = {0, 1};
+  CHECK_EQ(ValidationError(state), std::string("snake leaves no free cell for the food"));
+}
+
+/**
+ * @brief The text format reads every keyword and reports the line of a malformed one.
+ */
+void TestParse() {
+  std::istringstream in("# sample\n"
+                        "grid 10 10\n"
+                        "head 5 5\n"
+                        "body 5 6 5 7   # behind the head first\n"
+                        "body 5 8\n"
+                        "direction up\n"
+                        "speed 12.5\n"
+                        "score 3\n"
+                        "growing 1\n"
+                        "food 1 2\n");
+  BoardState state;
+  std::string error;
+  CHECK(ParseBoardText(in, state, error));
+  CHECK_EQ(state.grid_width, 10);
+  CHECK_EQ(state.body.size(), std::size_t{3});
+  CHECK_EQ(state.body[2].y, 8);
+  CHECK(state.direction == Snake::Direction::kUp);
+  CHECK_EQ(state.speed, 12.5f);
+  CHECK_EQ(state.score, 3);
+  CHECK(state.growing);
+  CHECK_EQ(state.food.y, 2);
+
+  CHECK_EQ(ParseError("grid 10 10\nspeed\n"), std::string("line 2: invalid speed"));
+  CHECK_EQ(ParseError("grid 10 10 10\n"), std::string("line 1: invalid grid"));
+  CHECK_EQ(ParseError("direction sideways\n"), std::string("line 1: invalid direction"));
+  CHECK_EQ(ParseError("body 16 17 16\n"), std::string("line 1: invalid body"));
+  CHECK_EQ(ParseError("\nfoo 1\n"), std::string("line 2: unknown keyword 'foo'"));
+
+  // Parsing does not validate; omitted keywords keep the defaults, which put the head on (16, 16)
+  std::istringstream on_head("food 16 16\n");
+  CHECK(ParseBoardText(on_head, state, error));
+  CHECK(!ValidateBoard(state, error));
+}
+
+/**
+ * @brief Generated boards are valid up to the grid side limit and leave one row's worth of cells free.
+ */
+void TestGenerators() {
+  BoardState state;
+  std::string error;
+  CHECK(MakeBoard("serpentine:10x10", state, error));
+  CHECK_EQ(state.body.size() + 1, std::size_t{90});
+  CHECK(MakeBoard("tangled:11x10", state, error));
+  CHECK_EQ(state.body.size() + 1, std::size_t{99});
+  CHECK(MakeBoard("tangled:" + std::to_string(kMaxGridSide) + "x4", state, error));
+  CHECK(!MakeBoard("tangled:" + std::to_string(kMaxGridSide + 1) + "x4", state, error));
+  CHECK(!MakeBoard("serpentine:2x2", state, error));
+  CHECK(!MakeBoard("serpentine:10", state, error));
+}
+
+} // namespace
+
+int main() {
+  TestValidate();
+  TestParse();
+  TestGenerators();
+  return CheckStatus();
+}
@@ -0,0 +1,47 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <iostream>
+
+/**
+ * @brief Minimal assertions for the unit tests, which run without a test framework.
+ *
+ * A failed CHECK prints the expression and its location and the test keeps going, so one run reports
+ * every broken expectation. Each test's main returns CheckStatus(), which ctest reads as pass or fail.
+ */
+inline int &CheckFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(condition)                                                                   \
+  do {                                                                                     \
+    if (!(condition)) {                                                                    \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n";     \
+      CheckFailures()++;                                                                   \
+    }                                                                                      \
+  } while (false)
+
+#define CHECK_EQ(actual, expected)                                                         \
+  do {                                                                                     \
+    const auto &check_actual = (actual);                                                   \
+    const auto &check_expected = (expected);                                               \
+    if (!(check_actual == check_expected)) {                                               \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_EQ(" #actual ", " #expected     \
+                << ") failed: " << check_actual << " != " << check_expected << "\n";       \
+      CheckFailures()++;                                                                   \
+    }                                                                                      \
+  } while (false)
+
+/**
+ * @brief Prints a summary and returns the process exit status: 0 if every check passed.
+ */
+inline int CheckStatus() {
+  if (CheckFailures() > 0) {
+    std::cerr << CheckFailures() << " check(s) failed\n";
+    return 1;
+  }
+  return 0;
+}
+
+#endif // CHECK_H
@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <string>
+#include "check.h"
+#include "boardstate.h"
+#include "headlesssim.h"
+#include "snake.h"
+
+namespace {
+
+/**
+ * @brief Runs both engines from the same start and checks that they end in the same state.
+ */
+void CheckEnginesAgree(int width, int height, std::uint32_t seed, std::uint64_t steps, const BoardState *board) {
+  HeadlessSim sim(width, height, seed, HeadlessSim::RandomScript(seed, steps), true);
+  if (board) {
+    sim.StartFrom(*board);
+  }
+  const HeadlessResult fixed = sim.RunFixedStep(steps);
+  const HeadlessResult events = sim.RunEventDriven(steps);
+  CHECK(fixed.SameState(events));
+  CHECK_EQ(fixed.steps, steps);
+  CHECK_EQ(fixed.work, steps);
+  CHECK(events.work <= fixed.work);
+  CHECK(fixed.cell_moves > 0);
+}
+
+/**
+ * @brief Fixed-step and event-driven runs agree on fresh games, generated boards and wide grids.
+ */
+void TestEnginesAgree() {
+  for (std::uint32_t seed = 1; seed <= 5; ++seed) {
+    CheckEnginesAgree(32, 32, seed, 100000, nullptr);
+  }
+
+  BoardState tangled;
+  std::string error;
+  CHECK(MakeBoard("tangled:40x30", tangled, error));
+  CheckEnginesAgree(40, 30, 5, 50000, &tangled);
+
+  // Grids wider than 2048 cells, where summing the head and the grid width in float used to round
+  CheckEnginesAgree(3000, 8, 11, 50000, nullptr);
+  CheckEnginesAgree(8, 4096, 12, 50000, nullptr);
+}
+
+/**
+ * @brief Advance gives exactly the position of repeated Update calls, including around the wrap.
+ */
+void TestAdvanceMatchesUpdate() {
+  const float kStep = 0.01f;
+  const Snake::Direction directions[] = {Snake::Direction::kRight, Snake::Direction::kLeft};
+  for (Snake::Direction direction : directions) {
+    Snake stepped(3000, 8);
+    Snake advanced(3000, 8);
+    stepped.head_x = advanced.head_x = 2999.0f + 3.0f / Snake::kPositionScale;
+    stepped.direction = advanced.direction = direction;
+    stepped.speed = advanced.speed = 7.3f;
+    for (int cell = 0; cell < 200; ++cell) {
+      const std::uint64_t steps = stepped.StepsUntilCellChange(kStep);
+      CHECK(steps > 0);
+      for (std::uint64_t i = 0; i < steps; ++i) {
+        stepped.Update(kStep);
+      }
+      advanced.Advance(steps - 1, kStep);
+      advanced.Update(kStep);
+      CHECK_EQ(advanced.head_x, stepped.head_x);
+      CHECK(stepped.head_x >= 0.0f && stepped.head_x < 3000.0f);
+      const float units = stepped.head_x * Snake::kPositionScale;
+      CHECK_EQ(units, static_cast<float>(static_cast<std::int64_t>(units)));
+    }
+  }
+}
+
+} // namespace
+
+int main() {
+  TestEnginesAgree();
+  TestAdvanceMatchesUpdate();
+  return CheckStatus();
+}
@@ -0,0 +1,81 @@
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include "check.h"
+#include "histogram.h"
+#include "metrics.h"
+
+namespace {
+
+/**
+ * @brief Every value lands in the bucket whose bounds enclose it, and bounds are at most 25% above it.
+ */
+void TestBucketBounds() {
+  for (int i = 0; i < Histogram::kSubBuckets; ++i) {
+    CHECK_EQ(Histogram::BucketIndex(i), i);
+    CHECK_EQ(Histogram::BucketUpperBound(i), static_cast<std::uint64_t>(i));
+  }
+  for (int i = 0; i + 1 < Histogram::kBuckets; ++i) {
+    const std::uint64_t bound = Histogram::BucketUpperBound(i);
+    CHECK_EQ(Histogram::BucketIndex(bound), i);
+    CHECK_EQ(Histogram::BucketIndex(bound + 1), i + 1);
+  }
+  for (std::uint64_t value = 1; value < (std::uint64_t{1} << 40); value = value * 3 + 1) {
+    const std::uint64_t bound = Histogram::BucketUpperBound(Histogram::BucketIndex(value));
+    CHECK(bound >= value);
+    CHECK(bound - value <= value / 4);
+  }
+  CHECK_EQ(Histogram::BucketIndex(~std::uint64_t{0}), Histogram::kBuckets - 1);
+}
+
+/**
+ * @brief Count, sum, max, percentiles and differences between snapshots.
+ */
+void TestSnapshots() {
+  Histogram histogram;
+  CHECK_EQ(histogram.Read().Percentile(50), std::uint64_t{0});
+  for (std::uint64_t value = 1; value <= 100; ++value) {
+    histogram.Record(value);
+  }
+  const Histogram::Snapshot first = histogram.Read();
+  CHECK_EQ(first.count, std::uint64_t{100});
+  CHECK_EQ(first.sum, std::uint64_t{5050});
+  CHECK_EQ(first.max, std::uint64_t{100});
+  CHECK(first.Mean() == 50.5);
+  CHECK_EQ(first.Percentile(100), std::uint64_t{100});
+  const std::uint64_t median = first.Percentile(50);
+  CHECK(median >= 50 && median <= 50 + 50 / 4);
+
+  histogram.Record(1000);
+  const Histogram::Snapshot delta = histogram.Read().Since(first);
+  CHECK_EQ(delta.count, std::uint64_t{1});
+  CHECK_EQ(delta.sum, std::uint64_t{1000});
+  CHECK_EQ(delta.buckets[Histogram::BucketIndex(1000)], std::uint64_t{1});
+}
+
+/**
+ * @brief The Prometheus export prints bounds and sums as exact decimal seconds.
+ */
+void TestPrometheusSeconds() {
+  Metrics &metrics = Metrics::Instance();
+  metrics.frame_time_us.Record(16777216);
+  metrics.frame_time_us.Record(1);
+  std::ostringstream out;
+  metrics.WritePrometheus(out);
+  const std::string text = out.str();
+  CHECK(text.find("snake_frame_time_seconds_sum 16.777217\n") != std::string::npos);
+  CHECK(text.find("snake_frame_time_seconds_bucket{le=\"0.000003\"} 1\n") != std::string::npos);
+  // Exported bounds are 2^k - 1 microseconds; with six significant digits 2^24 - 1 would print as 16.7772
+  CHECK(text.find("snake_frame_time_seconds_bucket{le=\"16.777215\"} 1\n") != std::string::npos);
+  CHECK(text.find("snake_frame_time_seconds_bucket{le=\"33.554431\"} 2\n") != std::string::npos);
+  CHECK(text.find("snake_frame_time_seconds_count 2\n") != std::string::npos);
+}
+
+} // namespace
+
+int main() {
+  TestBucketBounds();
+  TestSnapshots();
+  TestPrometheusSeconds();
+  return CheckStatus();
+}
@@ -0,0 +1,92 @@
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "check.h"
+#include "renderworkers.h"
+
+namespace {
+
+/**
+ * @brief Every chunk runs exactly once over its own range, whatever the thread count.
+ */
+void CheckChunks(RenderWorkers &workers, std::size_t items) {
+  const std::size_t chunks = RenderWorkers::Chunks(items);
+  std::unique_ptr<std::atomic<int>[]> calls(new std::atomic<int>[chunks + 1]);
+  for (std::size_t i = 0; i <= chunks; ++i) {
+    calls[i] = 0;
+  }
+  std::vector<std::size_t> begins(chunks + 1, 0);
+  std::vector<std::size_t> ends(chunks + 1, 0);
+  std::atomic<int> other_threads{0};
+  const std::thread::id caller = std::this_thread::get_id();
+
+  workers.ForEachChunk(items, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+    if (chunk >= chunks) {
+      calls[chunks]++;
+      return;
+    }
+    calls[chunk]++;
+    begins[chunk] = begin;
+    ends[chunk] = end;
+    if (std::this_thread::get_id() != caller) {
+      other_threads++;
+    }
+  });
+
+  CHECK_EQ(calls[chunks].load(), 0);
+  for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+    CHECK_EQ(calls[chunk].load(), 1);
+    CHECK_EQ(begins[chunk], chunk * RenderWorkers::kChunkSize);
+    CHECK_EQ(ends[chunk], std::min(items, (chunk + 1) * RenderWorkers::kChunkSize));
+  }
+  if (items < RenderWorkers::kParallelThreshold) {
+    CHECK_EQ(other_threads.load(), 0);
+  }
+}
+
+/**
+ * @brief Chunk ranges and the output combined in chunk order do not depend on the thread count.
+ */
+void TestChunkOrder() {
+  const std::size_t sizes[] = {0, 1, RenderWorkers::kChunkSize - 1, RenderWorkers::kChunkSize,
+                               RenderWorkers::kParallelThreshold - 1, RenderWorkers::kParallelThreshold,
+                               10 * RenderWorkers::kChunkSize + 7};
+  std::vector<std::size_t> reference;
+  for (unsigned threads : {1u, 2u, 4u, 8u}) {
+    RenderWorkers workers(threads);
+    CHECK_EQ(workers.Threads(), threads);
+    // Several jobs in a row on the same pool, as consecutive frames do
+    for (int round = 0; round < 3; ++round) {
+      for (std::size_t items : sizes) {
+        CheckChunks(workers, items);
+      }
+    }
+
+    const std::size_t items = 10 * RenderWorkers::kChunkSize + 7;
+    std::vector<std::vector<std::size_t>> chunk_output(RenderWorkers::Chunks(items));
+    workers.ForEachChunk(items, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; ++i) {
+        chunk_output[chunk].push_back(i * 7 % 1000);
+      }
+    });
+    std::vector<std::size_t> combined;
+    for (const std::vector<std::size_t> &output : chunk_output) {
+      combined.insert(combined.end(), output.begin(), output.end());
+    }
+    if (reference.empty()) {
+      reference = combined;
+      CHECK_EQ(reference.size(), items);
+    } else {
+      CHECK(combined == reference);
+    }
+  }
+}
+
+} // namespace
+
+int main() {
+  TestChunkOrder();
+  return CheckStatus();
+}
@@ -0,0 +1,149 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "boardstate.h"
+#include "savegame.h"
+#include "snake.h"
+
+namespace {
+
+const char *const kPath = "savegame_test.sav";
+
+/**
+ * @brief Writes raw bytes to the test's save file.
+ */
+void WriteFile(const std::vector<unsigned char> &image) {
+  std::ofstream file(kPath, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(image.data()), static_cast<std::streamsize>(image.size()));
+}
+
+/**
+ * @brief Builds the save image of a snake of three cells heading up on a 32x32 grid.
+ */
+std::vector<unsigned char> SampleImage(std::mt19937 &engine) {
+  Snake snake(32, 32);
+  const SDL_Point body[] = {{16, 17}, {16, 18}};
+  snake.Adopt(16.5f, 16.25f, Snake::Direction::kUp, 12.0f, false, body, 2);
+  std::vector<unsigned char> image;
+  BuildSaveImage(snake, SDL_Point{3, 4}, 2, engine, image);
+  return image;
+}
+
+/**
+ * @brief A saved game maps back to the same header, body and RNG state.
+ */
+void TestRoundTrip() {
+  std::mt19937 engine(42);
+  engine.discard(1000);
+  WriteFile(SampleImage(engine));
+  CHECK(IsSaveFile(kPath));
+
+  SaveFile save(kPath);
+  CHECK(save.Valid());
+  if (!save.Valid()) {
+    return;
+  }
+  const SaveHeader &header = save.Header();
+  CHECK_EQ(header.grid_width, 32);
+  CHECK_EQ(header.grid_height, 32);
+  CHECK_EQ(header.head_x, 16.5f);
+  CHECK_EQ(header.head_y, 16.25f);
+  CHECK_EQ(header.speed, 12.0f);
+  CHECK_EQ(header.size, 3);
+  CHECK_EQ(header.score, 2);
+  CHECK_EQ(header.body_length, std::uint64_t{2});
+  CHECK_EQ(save.Body()[1].y, 18);
+
+  std::mt19937 restored;
+  save.RestoreEngine(restored);
+  CHECK(restored == engine);
+
+  BoardState state;
+  std::string error;
+  BoardFromSave(save, state);
+  CHECK(ValidateBoard(state, error));
+}
+
+/**
+ * @brief Every header check rejects a file that breaks it.
+ */
+void TestRejectsBrokenHeaders() {
+  std::mt19937 engine(1);
+  const std::vector<unsigned char> image = SampleImage(engine);
+  const std::vector<std::function<void(std::vector<unsigned char> &)>> breakages = {
+      [](std::vector<unsigned char> &bytes) { bytes.resize(sizeof(SaveHeader)); },
+      [](std::vector<unsigned char> &bytes) { bytes.pop_back(); },
+      [](std::vector<unsigned char> &bytes) { bytes.push_back(0); },
+      [](std::vector<unsigned char> &bytes) { bytes[0] ^= 0xFF; },
+      [](std::vector<unsigned char> &bytes) { reinterpret_cast<SaveHeader *>(bytes.data())->version++; },
+      [](std::vector<unsigned char> &bytes) { reinterpret_cast<SaveHeader *>(bytes.data())->byte_order = 0; },
+      [](std::vector<unsigned char> &bytes) { reinterpret_cast<SaveHeader *>(bytes.data())->rng_size--; },
+      [](std::vector<unsigned char> &bytes) { reinterpret_cast<SaveHeader *>(bytes.data())->body_length = 1u << 30; },
+      [](std::vector<unsigned char> &bytes) { reinterpret_cast<SaveHeader *>(bytes.data())->direction = 4; },
+      [](std::vector<unsigned char> &bytes) { reinterpret_cast<SaveHeader *>(bytes.data())->size = 7; },
+      [](std::vector<unsigned char> &bytes) { reinterpret_cast<SaveHeader *>(bytes.data())->speed = -1.0f; },
+      [](std::vector<unsigned char> &bytes) { reinterpret_cast<SaveHeader *>(bytes.data())->head_x = 32.0f; },
+      [](std::vector<unsigned char> &bytes) { reinterpret_cast<SaveHeader *>(bytes.data())->food.y = -1; },
+      [](std::vector<unsigned char> &bytes) { reinterpret_cast<SaveHeader *>(bytes.data())->score = -1; },
+  };
+  for (const auto &breakage : breakages) {
+    std::vector<unsigned char> broken = image;
+    breakage(broken);
+    WriteFile(broken);
+    SaveFile save(kPath);
+    CHECK(!save.Valid());
+  }
+
+  // A body that is not a path passes the header checks but not the position check
+  std::vector<unsigned char> broken = image;
+  SDL_Point *body = reinterpret_cast<SDL_Point *>(broken.data() + broken.size()) - 2;
+  body[1] = SDL_Point{20, 20};
+  WriteFile(broken);
+  SaveFile save(kPath);
+  CHECK(save.Valid());
+  BoardState state;
+  std::string error;
+  BoardFromSave(save, state);
+  CHECK(!ValidateBoard(state, error));
+
+  std::remove(kPath);
+  SaveFile missing(kPath);
+  CHECK(!missing.Valid());
+}
+
+/**
+ * @brief The writer replaces the file with the latest image and removes it on Discard.
+ */
+void TestWriter() {
+  std::mt19937 engine(3);
+  std::vector<unsigned char> image = SampleImage(engine);
+  {
+    SaveWriter writer(kPath);
+    writer.Submit(image);
+  }
+  {
+    SaveFile save(kPath);
+    CHECK(save.Valid());
+  }
+  {
+    SaveWriter writer(kPath);
+    writer.Discard();
+  }
+  std::ifstream removed(kPath);
+  CHECK(!removed);
+}
+
+} // namespace
+
+int main() {
+  TestRoundTrip();
+  TestRejectsBrokenHeaders();
+  TestWriter();
+  std::remove(kPath);
+  return CheckStatus();
+}